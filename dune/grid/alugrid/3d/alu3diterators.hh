@@ -60,19 +60,30 @@ namespace ALUGridSpace
   //*********************************************************
   //  LevelIterator Wrapper
   //*********************************************************
+  /** \brief common base of the iterator wrappers
+   *
+   *  The wrappers are always used through their concrete type, which is
+   *  selected at compile time by codim and PartitionIteratorType.  Hence
+   *  this base has no virtual methods, each wrapper provides
+   *  \code
+   *  int size ();
+   *  void next ();
+   *  void first ();
+   *  int done () const;
+   *  val_t & item () const;
+   *  \endcode
+   *  and the calls from ALU3dGridTreeIterator and ALUGrid's AlignIterator
+   *  are bound statically and can be inlined.
+   */
   template< class val_t >
   class IteratorWrapperInterface
-    : public IteratorSTI< val_t >
   {
   public:
-    virtual ~IteratorWrapperInterface () {}
-
-    virtual int size  () = 0;
-    virtual void next () = 0;
-    virtual void first() = 0;
-    virtual int done  () const = 0;
-    virtual val_t & item () const = 0;
-    virtual IteratorSTI< val_t > * clone () const { assert(false); abort(); return 0; }
+    typedef val_t ValueType;
+
+  protected:
+    IteratorWrapperInterface () {}
+    ~IteratorWrapperInterface () {}
   };
 
   typedef Dune::PartitionIteratorType PartitionIteratorType;
@@ -544,6 +555,9 @@ namespace ALUGridSpace
   //  --GhostIterator
   //
   //****************************
+  //! base of the ghost element iterators, Implementation provides
+  //! newIterator and checkLeafEntity (Barton-Nackman trick)
+  template< class Implementation >
   class ALU3dGridGhostIterator
     : public IteratorWrapperInterface< LeafValType >
   {
@@ -621,10 +635,7 @@ namespace ALUGridSpace
     }
 
   protected:
-    virtual IteratorType * newIterator()
-    {
-      return new IteratorType ( gitter_, link_ );
-    }
+    Implementation &asImp () { return static_cast< Implementation & >( *this ); }
 
     void removeIterators()
     {
@@ -645,7 +656,7 @@ namespace ALUGridSpace
         removeIterators();
         if(link_ < nl_)
         {
-          iterTT_ = newIterator();
+          iterTT_ = asImp().newIterator();
           assert(iterTT_);
           checkInnerOuter();
           if (!it_) createIterator();
@@ -695,23 +706,6 @@ namespace ALUGridSpace
       it_ = 0;
     }
 
-    virtual void checkLeafEntity ()
-    {
-      if(it_)
-      {
-        if(!it_->done())
-        {
-          val_t & el = item();
-          HBndSegType * pll = el.second;
-          assert( pll );
-
-          // this occurs if internal element is leaf but the corresponding
-          // ghost is not leaf, we have to go next
-          if ( ! pll->isLeafEntity() ) next();
-        }
-      }
-    }
-
   public:
     int size  ()    // ???? gives size only of small part of ghost cells ????
     {
@@ -735,7 +729,7 @@ namespace ALUGridSpace
         // if now done, create new iterator
         if( it_->done() ) createIterator();
 
-        checkLeafEntity();
+        asImp().checkLeafEntity();
       }
     }
 
@@ -747,7 +741,7 @@ namespace ALUGridSpace
         usingInner_ = false;
         // create iterator calls also first of iterators
         createIterator();
-        checkLeafEntity();
+        asImp().checkLeafEntity();
         if( it_ ) assert( !it_->done());
       }
     }
@@ -775,8 +769,11 @@ namespace ALUGridSpace
   // the leaf ghost partition iterator
   template<>
   class ALU3dGridLeafIteratorWrapper< 0, Dune::Ghost_Partition, MPI_Comm >
-    : public ALU3dGridGhostIterator
+    : public ALU3dGridGhostIterator< ALU3dGridLeafIteratorWrapper< 0, Dune::Ghost_Partition, MPI_Comm > >
   {
+    typedef ALU3dGridGhostIterator< ALU3dGridLeafIteratorWrapper< 0, Dune::Ghost_Partition, MPI_Comm > > BaseType;
+    friend class ALU3dGridGhostIterator< ALU3dGridLeafIteratorWrapper< 0, Dune::Ghost_Partition, MPI_Comm > >;
+
   protected:
     typedef LeafLevelIteratorTTProxy<1> IteratorType;
     IteratorType * newIterator()
@@ -804,17 +801,20 @@ namespace ALUGridSpace
   public:
     template <class GridImp>
     ALU3dGridLeafIteratorWrapper(const GridImp & grid, int level , const int nlinks )
-      : ALU3dGridGhostIterator(grid,level,nlinks) {}
+      : BaseType(grid,level,nlinks) {}
 
     ALU3dGridLeafIteratorWrapper(const ALU3dGridLeafIteratorWrapper & org)
-      : ALU3dGridGhostIterator(org) {}
+      : BaseType(org) {}
   };
 
   // the level ghost partition iterator
   template<>
   class ALU3dGridLevelIteratorWrapper< 0, Dune::Ghost_Partition, MPI_Comm >
-    : public ALU3dGridGhostIterator
+    : public ALU3dGridGhostIterator< ALU3dGridLevelIteratorWrapper< 0, Dune::Ghost_Partition, MPI_Comm > >
   {
+    typedef ALU3dGridGhostIterator< ALU3dGridLevelIteratorWrapper< 0, Dune::Ghost_Partition, MPI_Comm > > BaseType;
+    friend class ALU3dGridGhostIterator< ALU3dGridLevelIteratorWrapper< 0, Dune::Ghost_Partition, MPI_Comm > >;
+
     const int level_;
     const int mxl_;
   protected:
@@ -851,11 +851,11 @@ namespace ALUGridSpace
   public:
     template <class GridImp>
     ALU3dGridLevelIteratorWrapper(const GridImp & grid,int level , const int nlinks )
-      : ALU3dGridGhostIterator(grid,level,nlinks)
+      : BaseType(grid,level,nlinks)
         , level_(level) , mxl_(grid.maxLevel()){}
 
     ALU3dGridLevelIteratorWrapper(const ALU3dGridLevelIteratorWrapper & org)
-      : ALU3dGridGhostIterator(org) , level_(org.level_) , mxl_(org.mxl_){}
+      : BaseType(org) , level_(org.level_) , mxl_(org.mxl_){}
   };
 
   ///////////////////////////////////////////
@@ -3,6 +3,8 @@
 #ifndef DUNE_ALU3DGRIDFACEUTILITY_HH
 #define DUNE_ALU3DGRIDFACEUTILITY_HH
 
+#include <vector>
+
 #include <dune/common/misc.hh>
 #include <dune/geometry/referenceelements.hh>
 
@@ -220,6 +222,91 @@ namespace Dune
 
 
 
+  // ALU3dGridFaceGeometryData
+  // -------------------------
+
+  //! The geometric data of a face seen from one of its sides, which is
+  //! computed on demand by the ALU3dGridGeometricFaceInfo classes
+  template< ALU3dGridElementType type >
+  struct ALU3dGridFaceGeometryData
+  {
+    typedef FieldVector< alu3d_ctype, 3 > NormalType;
+    typedef FieldMatrix< alu3d_ctype, EntityCount< type >::numVerticesPerFace, 3 > CoordinateType;
+
+    ALU3dGridFaceGeometryData ()
+      : coordsSelfLocal( -1.0 ),
+        coordsNeighborLocal( -1.0 ),
+        generatedLocal( false ),
+        normalUp2Date( false )
+    {}
+
+    //! mark everything as not computed
+    void reset ()
+    {
+      generatedLocal = false;
+      normalUp2Date = false;
+    }
+
+    //! the corners of the face in the reference element of the inside
+    CoordinateType coordsSelfLocal;
+    //! the corners of the face in the reference element of the outside
+    CoordinateType coordsNeighborLocal;
+    //! the integration outer normal, for hexahedra only if the face is affine
+    NormalType outerNormal;
+    //! the surface mapping of the face, only used for hexahedra
+    SurfaceNormalCalculator mappingGlobal;
+
+    bool generatedLocal;
+    //! true if outerNormal, for hexahedra mappingGlobal, is up to date
+    bool normalUp2Date;
+  };
+
+
+  // ALU3dGridFaceGeometryCache
+  // --------------------------
+
+  /** \brief cache of the geometric face data of the leaf intersections
+
+      For both sides of each face there is one ALU3dGridFaceGeometryData,
+      addressed by the hierarchic index of the face.  The side is given by
+      the sign of the twist of the face seen from the inside element.
+      The entries are filled lazily by the leaf intersection iterators and
+      have to be invalidated, by calling update, whenever the grid changes.
+      As the entries are filled while iterating, the cache must not be used
+      by several threads at once.
+   */
+  template< ALU3dGridElementType type >
+  class ALU3dGridFaceGeometryCache
+  {
+  public:
+    typedef ALU3dGridFaceGeometryData< type > DataType;
+
+    //! remove all entries
+    void clear ()
+    {
+      std::vector< DataType >().swap( data_ );
+    }
+
+    //! invalidate all entries and make room for the given number of faces
+    void update ( const int numFaces )
+    {
+      data_.resize( 2*numFaces );
+      for( size_t i = 0; i < data_.size(); ++i )
+        data_[ i ].reset();
+    }
+
+    //! return the entry of a face seen from one side, or 0 if there is none
+    DataType *data ( const int faceIndex, const int innerTwist )
+    {
+      const size_t i = 2*size_t( faceIndex ) + (innerTwist < 0 ? 1 : 0);
+      return (faceIndex >= 0 && i < data_.size()) ? &data_[ i ] : 0;
+    }
+
+  private:
+    std::vector< DataType > data_;
+  };
+
+
   // ALU3dGridGeometricFaceInfoBase
   // ------------------------------
 
@@ -262,12 +349,15 @@ namespace Dune
   public:
     typedef ALU3dGridFaceInfo< type, Comm > ConnectorType;
 
+    //! type of the geometric data, which may be cached
+    typedef ALU3dGridFaceGeometryData< type > DataType;
+
     //- constructors and destructors
     ALU3dGridGeometricFaceInfoBase(const ConnectorType &);
     ALU3dGridGeometricFaceInfoBase(const ALU3dGridGeometricFaceInfoBase &);
 
-    //! reset status of faceGeomInfo
-    void resetFaceGeom();
+    //! reset status of faceGeomInfo, use cached data if given
+    void resetFaceGeom( DataType *cached = 0 );
 
     //- functions
     const CoordinateType& intersectionSelfLocal() const;
@@ -294,11 +384,11 @@ namespace Dune
     //- private data
     const ConnectorType& connector_;
 
-    mutable CoordinateType coordsSelfLocal_;
-    mutable CoordinateType coordsNeighborLocal_;
+    // the geometric data, either ownData_ or an entry of the face geometry cache
+    DataType ownData_;
+    DataType *data_;
 
     mutable bool generatedGlobal_;
-    mutable bool generatedLocal_;
 
     inline static const ReferenceElementType& getReferenceElement()
     {
@@ -337,9 +427,6 @@ namespace Dune
 
     NormalType & outerNormal(const FieldVector<alu3d_ctype, 2>& local) const;
 
-    //! reset status of faceGeomInfo
-    void resetFaceGeom();
-
     //! update global geometry
     template <class GeometryImp>
     void buildGlobalGeom(GeometryImp& geo) const;
@@ -350,13 +437,6 @@ namespace Dune
 
   protected:
     using Base::connector_;
-
-  private:
-    //- private data
-    mutable NormalType outerNormal_;
-
-    // false if surface mapping needs a update
-    mutable bool normalUp2Date_;
   };
 
   //! Helper class which provides geometric face information for the
@@ -382,9 +462,6 @@ namespace Dune
 
     NormalType & outerNormal(const FieldVector<alu3d_ctype, 2>& local) const;
 
-    //! reset status of faceGeomInfo
-    void resetFaceGeom();
-
     //! update global geometry
     template <class GeometryImp>
     void buildGlobalGeom(GeometryImp& geo) const;
@@ -397,14 +474,14 @@ namespace Dune
     using Base::connector_;
 
   private:
+    // compute the outer normal of the surface mapping at local
+    void computeNormal(const SurfaceMappingType& mapping,
+                       const FieldVector<alu3d_ctype, 2>& local,
+                       NormalType& normal) const;
+
     //- private data
+    // the normal of a non-affine face, which depends on the local coordinate
     mutable NormalType outerNormal_;
-
-    // surface mapping for calculating the outer normal
-    mutable SurfaceMappingType mappingGlobal_;
-
-    // false if surface mapping needs a update
-    mutable bool mappingGlobalUp2Date_;
   };
 
 } // end namespace Dune
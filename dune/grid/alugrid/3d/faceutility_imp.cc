@@ -436,37 +436,41 @@ namespace Dune
   inline ALU3dGridGeometricFaceInfoBase< type, Comm >::
   ALU3dGridGeometricFaceInfoBase(const ConnectorType& connector) :
     connector_(connector),
-    coordsSelfLocal_(-1.0),
-    coordsNeighborLocal_(-1.0),
-    generatedGlobal_(false),
-    generatedLocal_(false)
+    ownData_(),
+    data_(&ownData_),
+    generatedGlobal_(false)
   {}
 
   template< ALU3dGridElementType type, class Comm >
   inline void
   ALU3dGridGeometricFaceInfoBase< type, Comm >::
-  resetFaceGeom()
+  resetFaceGeom( DataType *cached )
   {
     generatedGlobal_ = false;
-    generatedLocal_  = false;
+    if( cached )
+      data_ = cached;
+    else
+    {
+      data_ = &ownData_;
+      ownData_.reset();
+    }
   }
 
   template< ALU3dGridElementType type, class Comm >
   inline ALU3dGridGeometricFaceInfoBase< type, Comm >::
   ALU3dGridGeometricFaceInfoBase ( const ALU3dGridGeometricFaceInfoBase &orig )
     : connector_(orig.connector_),
-      coordsSelfLocal_(orig.coordsSelfLocal_),
-      coordsNeighborLocal_(orig.coordsNeighborLocal_),
-      generatedGlobal_(orig.generatedGlobal_),
-      generatedLocal_(orig.generatedLocal_)
+      ownData_(orig.ownData_),
+      data_(orig.data_ == &orig.ownData_ ? &ownData_ : orig.data_),
+      generatedGlobal_(orig.generatedGlobal_)
   {}
 
   template< ALU3dGridElementType type, class Comm >
   inline const typename ALU3dGridGeometricFaceInfoBase< type, Comm >::CoordinateType&
   ALU3dGridGeometricFaceInfoBase< type, Comm >::intersectionSelfLocal() const {
     generateLocalGeometries();
-    assert(generatedLocal_);
-    return coordsSelfLocal_;
+    assert(data_->generatedLocal);
+    return data_->coordsSelfLocal;
   }
 
   template< ALU3dGridElementType type, class Comm >
@@ -474,8 +478,8 @@ namespace Dune
   ALU3dGridGeometricFaceInfoBase< type, Comm >::intersectionNeighborLocal() const {
     assert(!connector_.outerBoundary());
     generateLocalGeometries();
-    assert(generatedLocal_);
-    return coordsNeighborLocal_;
+    assert(data_->generatedLocal);
+    return data_->coordsNeighborLocal;
   }
 
 
@@ -483,21 +487,13 @@ namespace Dune
   template< class Comm >
   inline ALU3dGridGeometricFaceInfoTetra< Comm >::
   ALU3dGridGeometricFaceInfoTetra(const ConnectorType& connector)
-    : Base( connector ), normalUp2Date_( false )
+    : Base( connector )
   {}
 
-  template< class Comm >
-  inline void ALU3dGridGeometricFaceInfoTetra< Comm >::
-  resetFaceGeom()
-  {
-    Base::resetFaceGeom();
-    normalUp2Date_ = false;
-  }
-
   template< class Comm >
   inline ALU3dGridGeometricFaceInfoTetra< Comm >::
   ALU3dGridGeometricFaceInfoTetra(const ALU3dGridGeometricFaceInfoTetra& orig)
-    : Base( orig ), normalUp2Date_( orig.normalUp2Date_ )
+    : Base( orig )
   {}
 
   template< class Comm >
@@ -524,8 +520,10 @@ namespace Dune
   ALU3dGridGeometricFaceInfoTetra< Comm >::
   outerNormal(const FieldVector<alu3d_ctype, 2>& local) const
   {
+    NormalType &outerNormal = this->data_->outerNormal;
+
     // if geomInfo was not reseted then normal is still correct
-    if(!normalUp2Date_)
+    if(!this->data_->normalUp2Date)
     {
       // calculate the normal
       const GEOFaceType & face = this->connector_.face();
@@ -538,14 +536,14 @@ namespace Dune
       const double factor = (this->connector_.innerTwist() < 0) ? 1.0 : -1.0;
 
       // see mapp_tetra_3d.h for this piece of code
-      outerNormal_[0] = factor * ((_p1[1]-_p0[1]) *(_p2[2]-_p1[2]) - (_p2[1]-_p1[1]) *(_p1[2]-_p0[2]));
-      outerNormal_[1] = factor * ((_p1[2]-_p0[2]) *(_p2[0]-_p1[0]) - (_p2[2]-_p1[2]) *(_p1[0]-_p0[0]));
-      outerNormal_[2] = factor * ((_p1[0]-_p0[0]) *(_p2[1]-_p1[1]) - (_p2[0]-_p1[0]) *(_p1[1]-_p0[1]));
+      outerNormal[0] = factor * ((_p1[1]-_p0[1]) *(_p2[2]-_p1[2]) - (_p2[1]-_p1[1]) *(_p1[2]-_p0[2]));
+      outerNormal[1] = factor * ((_p1[2]-_p0[2]) *(_p2[0]-_p1[0]) - (_p2[2]-_p1[2]) *(_p1[0]-_p0[0]));
+      outerNormal[2] = factor * ((_p1[0]-_p0[0]) *(_p2[1]-_p1[1]) - (_p2[0]-_p1[0]) *(_p1[1]-_p0[1]));
 
-      normalUp2Date_ = true;
+      this->data_->normalUp2Date = true;
     } // end if mapp ...
 
-    return outerNormal_;
+    return outerNormal;
   }
 
   //-sepcialisation for and hexa
@@ -553,24 +551,14 @@ namespace Dune
   inline ALU3dGridGeometricFaceInfoHexa< Comm >::
   ALU3dGridGeometricFaceInfoHexa(const ConnectorType& connector)
     : Base( connector )
-      , mappingGlobal_()
-      , mappingGlobalUp2Date_(false)
+      , outerNormal_()
   {}
 
-  template< class Comm >
-  inline void ALU3dGridGeometricFaceInfoHexa< Comm >::
-  resetFaceGeom()
-  {
-    Base::resetFaceGeom();
-    mappingGlobalUp2Date_ = false;
-  }
-
   template< class Comm >
   inline ALU3dGridGeometricFaceInfoHexa< Comm >::
   ALU3dGridGeometricFaceInfoHexa(const ALU3dGridGeometricFaceInfoHexa& orig)
     : Base( orig )
-      , mappingGlobal_(orig.mappingGlobal_)
-      , mappingGlobalUp2Date_(orig.mappingGlobalUp2Date_)
+      , outerNormal_(orig.outerNormal_)
   {}
 
   template< class Comm >
@@ -597,61 +585,79 @@ namespace Dune
   ALU3dGridGeometricFaceInfoHexa< Comm >::
   outerNormal(const FieldVector<alu3d_ctype, 2>& local) const
   {
-    // if mapping calculated and affine, nothing more to do
-    if ( mappingGlobal_.affine () && mappingGlobalUp2Date_ )
-      return outerNormal_ ;
+    typename Base::DataType &data = *(this->data_);
+    SurfaceMappingType &mappingGlobal = data.mappingGlobal;
 
     // update surface mapping
-    if(! mappingGlobalUp2Date_ )
+    if(! data.normalUp2Date )
     {
       const GEOFaceType & face = connector_.face();
       // update mapping to actual face
-      mappingGlobal_.buildMapping(
+      mappingGlobal.buildMapping(
         face.myvertex( FaceTopo::dune2aluVertex(0) )->Point(),
         face.myvertex( FaceTopo::dune2aluVertex(1) )->Point(),
         face.myvertex( FaceTopo::dune2aluVertex(2) )->Point(),
         face.myvertex( FaceTopo::dune2aluVertex(3) )->Point()
         );
-      mappingGlobalUp2Date_ = true;
+
+      // the normal of an affine face does not depend on local
+      if( mappingGlobal.affine() )
+        computeNormal( mappingGlobal, local, data.outerNormal );
+      data.normalUp2Date = true;
     }
 
+    // if mapping calculated and affine, nothing more to do
+    if ( mappingGlobal.affine () )
+      return data.outerNormal ;
+
     // calculate the normal
     // has to be calculated every time normal called, because
     // depends on local
+    computeNormal( mappingGlobal, local, outerNormal_ );
+    return outerNormal_;
+  }
+
+  template< class Comm >
+  inline void
+  ALU3dGridGeometricFaceInfoHexa< Comm >::
+  computeNormal(const SurfaceMappingType& mapping,
+                const FieldVector<alu3d_ctype, 2>& local,
+                NormalType& normal) const
+  {
     if (connector_.innerTwist() < 0)
-      mappingGlobal_.negativeNormal(local,outerNormal_);
+      mapping.negativeNormal(local,normal);
     else
-      mappingGlobal_.normal(local,outerNormal_);
-
-    // end if
-    return outerNormal_;
+      mapping.normal(local,normal);
   }
 
   template< ALU3dGridElementType type, class Comm >
   inline void ALU3dGridGeometricFaceInfoBase< type, Comm >::
   generateLocalGeometries() const
   {
-    if (!generatedLocal_) {
+    CoordinateType &coordsSelfLocal = data_->coordsSelfLocal;
+    CoordinateType &coordsNeighborLocal = data_->coordsNeighborLocal;
+
+    if (!data_->generatedLocal) {
       // Get the coordinates of the face in the reference element of the
       // adjoining inner and outer elements and initialise the respective
       // geometries
       switch (connector_.conformanceState())
       {
       case (ConnectorType::CONFORMING) :
-        referenceElementCoordinatesRefined(INNER, coordsSelfLocal_);
+        referenceElementCoordinatesRefined(INNER, coordsSelfLocal);
         // generate outer local geometry only when not at boundary
         // * in the parallel case, this needs to be altered for the ghost cells
         if (!connector_.outerBoundary()) {
-          referenceElementCoordinatesRefined(OUTER, coordsNeighborLocal_);
+          referenceElementCoordinatesRefined(OUTER, coordsNeighborLocal);
         } // end if
         break;
       case (ConnectorType::REFINED_INNER) :
-        referenceElementCoordinatesRefined(INNER, coordsSelfLocal_);
-        referenceElementCoordinatesUnrefined(OUTER, coordsNeighborLocal_);
+        referenceElementCoordinatesRefined(INNER, coordsSelfLocal);
+        referenceElementCoordinatesUnrefined(OUTER, coordsNeighborLocal);
         break;
       case (ConnectorType::REFINED_OUTER) :
-        referenceElementCoordinatesUnrefined(INNER, coordsSelfLocal_);
-        referenceElementCoordinatesRefined(OUTER, coordsNeighborLocal_);
+        referenceElementCoordinatesUnrefined(INNER, coordsSelfLocal);
+        referenceElementCoordinatesRefined(OUTER, coordsNeighborLocal);
         break;
       default :
         std::cerr << "ERROR: Wrong conformanceState in generateLocalGeometries! in: " << __FILE__ << " line: " << __LINE__<< std::endl;
@@ -659,7 +665,7 @@ namespace Dune
         exit(1);
       } // end switch
 
-      generatedLocal_ = true;
+      data_->generatedLocal = true;
     } // end if
   }
 
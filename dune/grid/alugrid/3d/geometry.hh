@@ -769,14 +769,9 @@ namespace Dune
     //! return storage provider for geometry objects
     static GeometryProviderType& geoProvider()
     {
-#ifdef USE_SMP_PARALLEL
-      typedef ALUGridObjectFactory< GridImp >  GridObjectFactoryType;
-      static std::vector< GeometryProviderType > storage( GridObjectFactoryType :: maxThreads() );
-      return storage[ GridObjectFactoryType :: threadNumber () ];
-#else
+      // the provider keeps one pool per thread
       static GeometryProviderType storage;
       return storage;
-#endif
     }
 
     // return reference to geometry implementation
@@ -24,6 +24,7 @@
 
 // bnd projection stuff
 #include <dune/grid/common/boundaryprojection.hh>
+#include <dune/grid/utility/graphpartitioner.hh>
 #include <dune/grid/alugrid/common/bndprojection.hh>
 #include <dune/grid/alugrid/common/objectfactory.hh>
 #include <dune/grid/alugrid/common/backuprestore.hh>
@@ -31,6 +32,7 @@
 //- Local includes
 #include "alu3dinclude.hh"
 #include "topology.hh"
+#include "faceutility.hh"
 #include "indexsets.hh"
 #include "datahandle.hh"
 
@@ -753,6 +755,36 @@ namespace Dune
       return loadBalance( lbHandle );
     }
 
+    /** \brief Weighted imbalance of the macro elements.
+
+        The weight functor is called for each interior macro element, e.g. to
+        return the number of its leaf children or a measured cost.  The
+        imbalance is the largest load of a process over the mean load, see
+        loadBalanceStatistics().  This is a collective operation.
+     */
+    template< class Weight >
+    double weightedImbalance ( const Weight &weight ) const;
+
+    /** \brief Call loadBalance() only if the weighted load is out of balance.
+
+        The macro elements are weighted by the given functor.  If the
+        weighted imbalance does not exceed 1 + tolerance, nothing is moved
+        and false is returned.  Otherwise loadBalance() is called.  The
+        weights are not passed on: ALUGrid partitions by its own element
+        counts, so the new partition does not follow the weights.  This is
+        not weighted load balancing, it only decides when to rebalance.
+
+        \param imbalance the weighted imbalance before repartitioning
+     */
+    template< class Weight >
+    bool loadBalanceIfImbalanced ( const Weight &weight, double tolerance, double &imbalance );
+
+    /** \brief Call loadBalance( data ) only if the weighted load is out of balance
+        \param data a data handle as for loadBalance( DataHandle & ) or a CommDataHandleIF
+     */
+    template< class Weight, class DataHandle >
+    bool loadBalanceIfImbalanced ( const Weight &weight, double tolerance, double &imbalance, DataHandle &data );
+
     /** \brief ghostSize is one for codim 0 and zero otherwise for this grid  */
     int ghostSize (int level, int codim) const;
 
@@ -836,6 +868,36 @@ namespace Dune
     // (no interface method) get hierarchic index set of the grid
     const HierarchicIndexSet & hierarchicIndexSet () const { return hIndexSet_; }
 
+    /** \brief switch the cache of the geometric data of the leaf intersections on or off
+
+        With the cache, the outer normals and the geometries of the leaf
+        intersections in the inside and outside elements are computed once
+        per face and kept until the grid changes.  This pays off if the leaf
+        intersections are visited several times on an unchanged grid.
+        The cache is filled while iterating, so it must not be switched on
+        while several threads iterate over the grid.
+     */
+    void setFaceGeometryCaching ( const bool caching )
+    {
+      faceGeometryCaching_ = caching;
+      if( caching )
+        faceGeometryCache_.update( hierSetSize( 1 ) );
+      else
+        faceGeometryCache_.clear();
+    }
+
+    // type of the cached geometric data of a face
+    typedef typename ALU3dGridFaceGeometryCache< elType >::DataType FaceGeometryDataType;
+
+    // (no interface method) return the cached data of a leaf face seen
+    // from the side with the given twist, or 0 if caching is off
+    FaceGeometryDataType *
+    faceGeometryCacheData ( const typename ALU3dImplTraits< elType, Comm >::GEOFaceType &face,
+                            const int innerTwist ) const
+    {
+      return faceGeometryCaching_ ? faceGeometryCache_.data( face.getIndex(), innerTwist ) : 0;
+    }
+
     // set max of given mxl and actual maxLevel
     // for loadBalance
     void setMaxLevel (int mxl);
@@ -1090,6 +1152,10 @@ namespace Dune
     // variable to ensure that postAdapt ist called after adapt
     bool lockPostAdapt_;
 
+    // geometric data of the leaf intersections, only used if faceGeometryCaching_ is true
+    bool faceGeometryCaching_;
+    mutable ALU3dGridFaceGeometryCache< elType > faceGeometryCache_;
+
     // pointer to Dune boundary projection
     const DuneBoundaryProjectionType* bndPrj_;
 
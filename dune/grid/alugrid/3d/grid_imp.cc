@@ -366,6 +366,10 @@ namespace Dune
     if(sizeCache_) delete sizeCache_;
     sizeCache_ = new SizeCacheType (*this);
 
+    // the cached face geometries belong to the old grid
+    if( faceGeometryCaching_ )
+      faceGeometryCache_.update( hierSetSize( 1 ) );
+
     // unset up2date before recalculating the index sets,
     // becasue they will use this feature
     leafVertexList_.unsetUp2Date();
@@ -42,6 +42,8 @@ namespace Dune
       , factory_( *this )
 #endif
       , lockPostAdapt_( false )
+      , faceGeometryCaching_( false )
+      , faceGeometryCache_()
       , bndPrj_ ( bndPrj )
       , bndVec_ ( (bndVec) ? (new DuneBoundaryProjectionVector( *bndVec )) : 0 )
       , vertexProjection_( (bndPrj || bndVec) ? new ALUGridBoundaryProjectionType( *this ) : 0 )
@@ -666,6 +668,48 @@ namespace Dune
   }
 
 
+  // weighted load of the macro elements
+  template< ALU3dGridElementType elType, class Comm >
+  template< class Weight >
+  inline double
+  ALU3dGrid< elType, Comm >::weightedImbalance ( const Weight &weight ) const
+  {
+    typedef typename Traits :: template Partition< All_Partition > :: LevelGridView MacroView;
+    const MacroView macroView = this->levelView( 0 );
+
+    // every macro element stays where it is
+    const MultipleCodimMultipleGeomTypeMapper< MacroView, MCMGElementLayout > mapper( macroView );
+    const std::vector< int > targetProcessors( mapper.size(), comm().rank() );
+    return loadBalanceStatistics( macroView, weight, targetProcessors ).imbalance;
+  }
+
+
+  // load balance grid if the weighted load is out of balance
+  template< ALU3dGridElementType elType, class Comm >
+  template< class Weight >
+  inline bool ALU3dGrid< elType, Comm >::
+  loadBalanceIfImbalanced ( const Weight &weight, double tolerance, double &imbalance )
+  {
+    imbalance = weightedImbalance( weight );
+    if( imbalance <= 1.0 + tolerance )
+      return false;
+    return loadBalance();
+  }
+
+
+  // load balance grid if the weighted load is out of balance
+  template< ALU3dGridElementType elType, class Comm >
+  template< class Weight, class DataHandle >
+  inline bool ALU3dGrid< elType, Comm >::
+  loadBalanceIfImbalanced ( const Weight &weight, double tolerance, double &imbalance, DataHandle &data )
+  {
+    imbalance = weightedImbalance( weight );
+    if( imbalance <= 1.0 + tolerance )
+      return false;
+    return loadBalance( data );
+  }
+
+
   // communicate level data
   template< ALU3dGridElementType elType, class Comm >
   template <class DataHandleImp,class DataType>
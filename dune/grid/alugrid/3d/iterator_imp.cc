@@ -452,7 +452,8 @@ namespace Dune {
     assert( innerLevel_ == item_->level() );
     connector_.updateFaceInfo(newFace,innerLevel_,
                               item_->twist(ElementTopo::dune2aluFace(index_)) );
-    geoProvider_.resetFaceGeom();
+    // the faces of leaf intersections may have cached geometric data
+    geoProvider_.resetFaceGeom( factory_.grid().faceGeometryCacheData( newFace, connector_.innerTwist() ) );
   }
 
   template <class GridImp>
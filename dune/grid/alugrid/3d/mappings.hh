@@ -6,6 +6,7 @@
 // System includes
 #include <limits>
 #include <cmath>
+#include <vector>
 
 // Dune includes
 #include <dune/common/fvector.hh>
@@ -25,6 +26,33 @@ namespace Dune {
   template< ALU3dGridElementType, class >
   class ALU3dGrid;
 
+  //! The values of a mapping at a batch of local points, e.g., at the points
+  //! of a quadrature rule, stored as a structure of arrays:
+  //! global[ i ][ p ] is the i-th coordinate of the image of point p and
+  //! jacobianInverseTransposed[ i ][ j ][ p ] is the entry (i,j) at point p
+  template< int mydim, int cdim >
+  struct MappingBatch
+  {
+    //! number of points
+    size_t size () const { return integrationElement.size(); }
+
+    //! make room for n points
+    void resize ( const size_t n )
+    {
+      for( int i = 0; i < cdim; ++i )
+      {
+        global[ i ].resize( n );
+        for( int j = 0; j < mydim; ++j )
+          jacobianInverseTransposed[ i ][ j ].resize( n );
+      }
+      integrationElement.resize( n );
+    }
+
+    std::vector< alu3d_ctype > global[ cdim ];
+    std::vector< alu3d_ctype > jacobianInverseTransposed[ cdim ][ mydim ];
+    std::vector< alu3d_ctype > integrationElement;
+  };
+
   //! A trilinear mapping from the Dune reference hexahedron into the physical
   //! space (same as in mapp_cube_3d.h, but for a different reference hexahedron)
   class TrilinearMapping
@@ -71,6 +99,9 @@ namespace Dune {
                     coord_t&) const ;
     void world2map (const coord_t&, coord_t&) ;
 
+    //! evaluate map2world, jacobianInverseTransposed and det at all points
+    void evaluate (const std::vector< coord_t >&, MappingBatch< 3, 3 >&) const ;
+
     template <class vector_t>
     void buildMapping(const vector_t&, const vector_t&,
                       const vector_t&, const vector_t&,
@@ -208,6 +239,9 @@ namespace Dune {
     void map2world(const coord2_t&, coord3_t&) const ;
     void map2world(const alu3d_ctype ,const alu3d_ctype , coord3_t&) const ;
 
+    //! evaluate map2world, jacobianInverseTransposed and det at all points
+    void evaluate (const std::vector< coord2_t >&, MappingBatch< 2, 3 >&) const ;
+
   private:
     void map2worldnormal(const alu3d_ctype, const alu3d_ctype, const alu3d_ctype , coord3_t&) const;
     void map2worldlinear(const alu3d_ctype, const alu3d_ctype, const alu3d_ctype ) const;
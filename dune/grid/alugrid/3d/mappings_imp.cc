@@ -218,6 +218,89 @@ namespace Dune {
     return ;
   }
 
+  alu_inline void TrilinearMapping ::
+  evaluate (const std::vector< coord_t >& local, MappingBatch< 3, 3 >& values) const
+  {
+    const size_t n = local.size();
+    values.resize( n );
+    if( n == 0 ) return ;
+
+    // the local coordinates as arrays, so that the loops below can be vectorised
+    std::vector< alu3d_ctype > xs( n ), ys( n ), zs( n );
+    for( size_t p = 0; p < n; ++p )
+    {
+      xs[ p ] = local[ p ][ 0 ];
+      ys[ p ] = local[ p ][ 1 ];
+      zs[ p ] = local[ p ][ 2 ];
+    }
+    const alu3d_ctype *x = &xs[ 0 ];
+    const alu3d_ctype *y = &ys[ 0 ];
+    const alu3d_ctype *z = &zs[ 0 ];
+
+    for( int j = 0; j < 3; ++j )
+    {
+      alu3d_ctype *world = &values.global[ j ][ 0 ];
+      const alu3d_ctype a0 = a[0][j], a1 = a[1][j], a2 = a[2][j], a3 = a[3][j];
+      const alu3d_ctype a4 = a[4][j], a5 = a[5][j], a6 = a[6][j], a7 = a[7][j];
+      for( size_t p = 0; p < n; ++p )
+        world[ p ] = a0 + a1 * x[p] + a2 * y[p] + a3 * z[p] + a4 * x[p] * y[p]
+                     + a5 * y[p] * z[p] + a6 * x[p] * z[p] + a7 * x[p] * y[p] * z[p] ;
+    }
+
+    alu3d_ctype *Dfi[3][3];
+    for( int i = 0; i < 3; ++i )
+      for( int j = 0; j < 3; ++j )
+        Dfi[i][j] = &values.jacobianInverseTransposed[ i ][ j ][ 0 ];
+    alu3d_ctype *detDf = &values.integrationElement[ 0 ];
+
+    // the derivatives of an affine mapping are the same everywhere
+    const size_t m = affine_ ? 1 : n;
+    for( size_t p = 0; p < m; ++p )
+    {
+      const alu3d_ctype yz = y[p] * z[p] ;
+      const alu3d_ctype xz = x[p] * z[p] ;
+      const alu3d_ctype xy = x[p] * y[p] ;
+
+      // derivatives with respect to x, y and z, see linear
+      const alu3d_ctype d00 = a[1][0] + y[p] * a[4][0] + z[p] * a[6][0] + yz * a[7][0] ;
+      const alu3d_ctype d01 = a[1][1] + y[p] * a[4][1] + z[p] * a[6][1] + yz * a[7][1] ;
+      const alu3d_ctype d02 = a[1][2] + y[p] * a[4][2] + z[p] * a[6][2] + yz * a[7][2] ;
+      const alu3d_ctype d10 = a[2][0] + x[p] * a[4][0] + z[p] * a[5][0] + xz * a[7][0] ;
+      const alu3d_ctype d11 = a[2][1] + x[p] * a[4][1] + z[p] * a[5][1] + xz * a[7][1] ;
+      const alu3d_ctype d12 = a[2][2] + x[p] * a[4][2] + z[p] * a[5][2] + xz * a[7][2] ;
+      const alu3d_ctype d20 = a[3][0] + y[p] * a[5][0] + x[p] * a[6][0] + xy * a[7][0] ;
+      const alu3d_ctype d21 = a[3][1] + y[p] * a[5][1] + x[p] * a[6][1] + xy * a[7][1] ;
+      const alu3d_ctype d22 = a[3][2] + y[p] * a[5][2] + x[p] * a[6][2] + xy * a[7][2] ;
+
+      // determinant and inverse^T, see det and inverse
+      const alu3d_ctype det = d00 * (d11 * d22 - d21 * d12)
+                              - d01 * (d10 * d22 - d20 * d12)
+                              + d02 * (d10 * d21 - d20 * d11) ;
+      const alu3d_ctype val = 1.0 / det ;
+
+      detDf[p] = det ;
+      Dfi[0][0][p] = ( d11 * d22 - d21 * d12 ) * val ;
+      Dfi[1][0][p] = ( d20 * d12 - d10 * d22 ) * val ;
+      Dfi[2][0][p] = ( d10 * d21 - d20 * d11 ) * val ;
+      Dfi[0][1][p] = ( d21 * d02 - d01 * d22 ) * val ;
+      Dfi[1][1][p] = ( d00 * d22 - d20 * d02 ) * val ;
+      Dfi[2][1][p] = ( d20 * d01 - d00 * d21 ) * val ;
+      Dfi[0][2][p] = ( d01 * d12 - d11 * d02 ) * val ;
+      Dfi[1][2][p] = ( d10 * d02 - d00 * d12 ) * val ;
+      Dfi[2][2][p] = ( d00 * d11 - d10 * d01 ) * val ;
+    }
+
+    for( size_t p = m; p < n; ++p )
+    {
+      detDf[p] = detDf[0] ;
+      for( int i = 0; i < 3; ++i )
+        for( int j = 0; j < 3; ++j )
+          Dfi[i][j][p] = Dfi[i][j][0] ;
+    }
+
+    assert( detDf[0] > 0 );
+  }
+
   alu_inline void TrilinearMapping::world2map (const coord_t& wld , coord_t& map )
   {
     //  Newton - Iteration zum Invertieren der Abbildung f.
@@ -438,6 +521,77 @@ namespace Dune {
   }
 
 
+  alu_inline void BilinearSurfaceMapping ::
+  evaluate (const std::vector< coord2_t >& local, MappingBatch< 2, 3 >& values) const
+  {
+    const size_t n = local.size();
+    values.resize( n );
+    if( n == 0 ) return ;
+
+    // the local coordinates as arrays, so that the loops below can be vectorised
+    std::vector< alu3d_ctype > xs( n ), ys( n );
+    for( size_t p = 0; p < n; ++p )
+    {
+      xs[ p ] = local[ p ][ 0 ];
+      ys[ p ] = local[ p ][ 1 ];
+    }
+    const alu3d_ctype *x = &xs[ 0 ];
+    const alu3d_ctype *y = &ys[ 0 ];
+
+    for( int j = 0; j < 3; ++j )
+    {
+      alu3d_ctype *world = &values.global[ j ][ 0 ];
+      const alu3d_ctype b0 = _b[0][j], b1 = _b[1][j], b2 = _b[2][j], b3 = _b[3][j];
+      for( size_t p = 0; p < n; ++p )
+        world[ p ] = b0 + x[p] * b1 + y[p] * b2 + x[p] * y[p] * b3 ;
+    }
+
+    alu3d_ctype *inv[3][2];
+    for( int i = 0; i < 3; ++i )
+      for( int j = 0; j < 2; ++j )
+        inv[i][j] = &values.jacobianInverseTransposed[ i ][ j ][ 0 ];
+    alu3d_ctype *det = &values.integrationElement[ 0 ];
+
+    // the derivatives of an affine mapping are the same everywhere
+    const size_t m = _affine ? 1 : n;
+    for( size_t p = 0; p < m; ++p )
+    {
+      // the tangents t and s and the normal, see map2worldlinear
+      const alu3d_ctype t0 = _b[1][0] + y[p] * _b[3][0] ;
+      const alu3d_ctype t1 = _b[1][1] + y[p] * _b[3][1] ;
+      const alu3d_ctype t2 = _b[1][2] + y[p] * _b[3][2] ;
+      const alu3d_ctype s0 = _b[2][0] + x[p] * _b[3][0] ;
+      const alu3d_ctype s1 = _b[2][1] + x[p] * _b[3][1] ;
+      const alu3d_ctype s2 = _b[2][2] + x[p] * _b[3][2] ;
+      const alu3d_ctype n0 = -(_n[0][0] + _n[1][0] * x[p] + _n[2][0] * y[p]) ;
+      const alu3d_ctype n1 = -(_n[0][1] + _n[1][1] * x[p] + _n[2][1] * y[p]) ;
+      const alu3d_ctype n2 = -(_n[0][2] + _n[1][2] * x[p] + _n[2][2] * y[p]) ;
+
+      // the first two rows of the inverse of (t,s,n) are (s x n) / D and (n x t) / D
+      const alu3d_ctype sn0 = s1 * n2 - s2 * n1 ;
+      const alu3d_ctype sn1 = s2 * n0 - s0 * n2 ;
+      const alu3d_ctype sn2 = s0 * n1 - s1 * n0 ;
+      const alu3d_ctype val = 1.0 / ( t0 * sn0 + t1 * sn1 + t2 * sn2 ) ;
+
+      inv[0][0][p] = sn0 * val ;
+      inv[1][0][p] = sn1 * val ;
+      inv[2][0][p] = sn2 * val ;
+      inv[0][1][p] = ( n1 * t2 - n2 * t1 ) * val ;
+      inv[1][1][p] = ( n2 * t0 - n0 * t2 ) * val ;
+      inv[2][1][p] = ( n0 * t1 - n1 * t0 ) * val ;
+
+      det[p] = std::sqrt( n0 * n0 + n1 * n1 + n2 * n2 ) ;
+    }
+
+    for( size_t p = m; p < n; ++p )
+    {
+      det[p] = det[0] ;
+      for( int i = 0; i < 3; ++i )
+        for( int j = 0; j < 2; ++j )
+          inv[i][j][p] = inv[i][j][0] ;
+    }
+  }
+
   alu_inline void BilinearSurfaceMapping ::
   map2worldnormal (const alu3d_ctype x,
                    const alu3d_ctype y,
@@ -7,35 +7,100 @@
 #include <cstdlib>
 #include <vector>
 
-namespace ALUGridSpace
-{
-  template<class T, int length>
-  class ALUGridFiniteStack ;
-}
+#if defined USE_PTHREADS || defined _OPENMP
+#define USE_SMP_PARALLEL
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/threads/threadmanager.hh>
+#endif
 
 namespace Dune {
 
-  //! organize the memory management for entitys used by the NeighborIterator
+  //! number of the calling thread and maximal number of threads
+  struct ALUGridThreads
+  {
+    // return thread number
+    static inline int threadNumber()
+    {
+#ifdef _OPENMP
+      return omp_get_thread_num();
+#elif HAVE_DUNE_FEM
+      return Fem :: ThreadManager :: thread() ;
+#else
+      return 0;
+#endif
+    }
+
+    // return maximal possible number of threads
+    static inline int maxThreads() {
+#ifdef _OPENMP
+      return omp_get_max_threads();
+#elif HAVE_DUNE_FEM
+      return Fem :: ThreadManager :: maxThreads() ;
+#else
+      return 1;
+#endif
+    }
+  };
+
+  /** \brief organize the memory management for entitys used by the NeighborIterator
+
+      Freed objects are kept for reuse in a pool of the thread freeing them.
+      Each pool is only touched by its own thread, hence several threads can
+      get and free objects of the same provider concurrently without any
+      locking.  A pool holds at most maxStackObjects objects, further freed
+      objects are deleted.  Threads without a pool, i.e. with a number beyond
+      the maximal number of threads at construction, neither recycle nor keep
+      objects.
+   */
   template <class Object>
   class ALUMemoryProvider
   {
+    typedef ALUMemoryProvider < Object > MyType;
+
     enum { maxStackObjects = 256 };
-    typedef ALUGridSpace :: ALUGridFiniteStack< Object* , maxStackObjects > StackType ;
-    StackType objStack_ ;
 
-    typedef ALUMemoryProvider < Object > MyType;
+    // the pool of one thread, padded to avoid false sharing
+    struct Pool
+    {
+      std::vector< Object* > objects;
+      char padding[ 64 ];
+    };
+
+    std::vector< Pool > pools_;
 
-    StackType& objStack() { return objStack_ ; }
+    //! return the pool of the calling thread, NULL if it has none
+    std::vector< Object* >* objStack()
+    {
+#ifdef USE_SMP_PARALLEL
+      const int thread = ALUGridThreads :: threadNumber();
+      return (thread >= 0 && thread < (int) pools_.size()) ? &pools_[ thread ].objects : 0 ;
+#else
+      return &pools_[ 0 ].objects ;
+#endif
+    }
+
+    //! true if the pool of the calling thread has an object for reuse
+    bool hasObject()
+    {
+      std::vector< Object* >* stk = objStack();
+      return stk && ! stk->empty();
+    }
 
   public:
     typedef Object ObjectType;
 
     //!default constructor
-    ALUMemoryProvider() {}
+    ALUMemoryProvider() : pools_( ALUGridThreads :: maxThreads() ) {}
 
     //! do not copy pointers
     ALUMemoryProvider(const ALUMemoryProvider<Object> & org)
-      : objStack_( org.objStack_ )
+      : pools_( org.pools_.size() )
     {}
 
     //! call deleteEntity
@@ -49,7 +114,7 @@ namespace Dune {
     template <class FactoryType, class EntityImp>
     inline ObjectType * getEntityObject(const FactoryType& factory, int level , EntityImp * fakePtr )
     {
-      if( objStack().empty() )
+      if( ! hasObject() )
       {
         return ( new ObjectType(EntityImp(factory,level) ));
       }
@@ -65,15 +130,26 @@ namespace Dune {
     //! i.e. return pointer to Entity
     ObjectType * getObjectCopy(const ObjectType & org);
 
-    //! free, move element to stack, returns NULL
+    //! free, move element to the pool of the calling thread or delete it if the pool is full
     void freeObject (ObjectType * obj);
 
+    //! number of objects kept for reuse by the given thread
+    size_t poolSize ( int thread ) const
+    {
+      return (thread >= 0 && thread < (int) pools_.size()) ? pools_[ thread ].objects.size() : 0 ;
+    }
+
+    //! maximal number of objects kept for reuse by one thread
+    static size_t maxPoolSize () { return maxStackObjects; }
+
   protected:
     inline ObjectType * stackObject()
     {
-      assert( ! objStack().empty() );
-      // finite stack does also return object on pop
-      return objStack().pop();
+      std::vector< Object* >* stk = objStack();
+      assert( stk && ! stk->empty() );
+      ObjectType * obj = stk->back();
+      stk->pop_back();
+      return obj;
     }
 
   };
@@ -89,7 +165,7 @@ namespace Dune {
   ALUMemoryProvider<Object>::getObject
     (const FactoryType &factory, int level )
   {
-    if( objStack().empty() )
+    if( ! hasObject() )
     {
       return ( new Object (factory, level) );
     }
@@ -104,7 +180,7 @@ namespace Dune {
   ALUMemoryProvider<Object>::getObjectCopy
     (const ObjectType & org )
   {
-    if( objStack().empty() )
+    if( ! hasObject() )
     {
       return ( new Object (org) );
     }
@@ -118,7 +194,7 @@ namespace Dune {
   inline typename ALUMemoryProvider<Object>::ObjectType *
   ALUMemoryProvider<Object>::getEmptyObject ()
   {
-    if( objStack().empty() )
+    if( ! hasObject() )
     {
       return new Object () ;
     }
@@ -131,26 +207,24 @@ namespace Dune {
   template <class Object>
   inline ALUMemoryProvider<Object>::~ALUMemoryProvider()
   {
-    StackType& objStk = objStack_;
-    while ( ! objStk.empty() )
+    for( size_t p = 0; p < pools_.size(); ++p )
     {
-      ObjectType * obj = objStk.pop();
-      delete obj;
+      std::vector< Object* >& objStk = pools_[ p ].objects;
+      for( size_t i = 0; i < objStk.size(); ++i )
+        delete objStk[ i ];
     }
   }
 
   template <class Object>
   inline void ALUMemoryProvider<Object>::freeObject(Object * obj)
   {
-    StackType& stk = objStack();
-    if( stk.full() )
-      delete obj;
+    std::vector< Object* >* stk = objStack();
+    if( stk && (int) stk->size() < maxStackObjects )
+      stk->push_back( obj );
     else
-      stk.push( obj );
+      delete obj;
   }
 
-#undef USE_FINITE_STACK
-
 } // end namespace Dune
 
 #endif
@@ -5,18 +5,6 @@
 
 #include <dune/grid/alugrid/common/memory.hh>
 
-#if defined USE_PTHREADS || defined _OPENMP
-#define USE_SMP_PARALLEL
-#endif
-
-#ifdef _OPENMP
-#include <omp.h>
-#endif
-
-#if HAVE_DUNE_FEM
-#include <dune/fem/misc/threads/threadmanager.hh>
-#endif
-
 namespace Dune
 {
   template <class InterfaceType>
@@ -193,27 +181,10 @@ namespace Dune
     void freeIntersection(LevelIntersectionIteratorImp & it) const { levelInterItProvider_.freeObject( &it ); }
 
     // return thread number
-    static inline int threadNumber()
-    {
-#ifdef _OPENMP
-      return omp_get_thread_num();
-#elif HAVE_DUNE_FEM
-      return Fem :: ThreadManager :: thread() ;
-#else
-      return 0;
-#endif
-    }
+    static inline int threadNumber() { return ALUGridThreads :: threadNumber(); }
 
     // return maximal possible number of threads
-    static inline int maxThreads() {
-#ifdef _OPENMP
-      return omp_get_max_threads();
-#elif HAVE_DUNE_FEM
-      return Fem :: ThreadManager :: maxThreads() ;
-#else
-      return 1;
-#endif
-    }
+    static inline int maxThreads() { return ALUGridThreads :: maxThreads(); }
   }; /// end class ALUGridObjectFactory
 
 }  // end namespace Dune
@@ -3,6 +3,7 @@
 #ifndef DUNE_ONE_D_GRID_HH
 #define DUNE_ONE_D_GRID_HH
 
+#include <map>
 #include <vector>
 #include <list>
 
@@ -292,6 +293,20 @@ namespace Dune {
       return leafIndexSet_;
     }
 
+    /** \brief The leaf indices changed by the last adaptation
+
+       adapt() keeps the leaf indices of the entities that stay in the leaf grid, except
+       for the few that are moved to close the holes left by removed entities.  The map
+       sends the old leaf index of each moved entity of the given codimension to its
+       current one, and the old index of each entity that has left the leaf grid to -1.
+       Indices not in the map are unchanged.  The map is empty as long as the leaf
+       indices have only been numbered from scratch.
+     */
+    const std::map<int,int>& leafIndexMap(int codim) const
+    {
+      return leafIndexSet_.indexMap(codim);
+    }
+
 
     /** \brief Mark entity for refinement
      *
@@ -386,6 +401,20 @@ namespace Dune {
     /** \brief Update all indices and ids */
     void setIndices();
 
+    /** \brief Report a new entity to the level index set, if it exists */
+    template <int mydim>
+    void levelIndexSetInsert(int level, OneDEntityImp<mydim>* e) {
+      if (level < (int)levelIndexSets_.size() && levelIndexSets_[level])
+        levelIndexSets_[level]->insert(e);
+    }
+
+    /** \brief Report the removal of an entity to the level index set, if it exists */
+    template <int mydim>
+    void levelIndexSetRemove(int level, const OneDEntityImp<mydim>* e) {
+      if (level < (int)levelIndexSets_.size() && levelIndexSets_[level])
+        levelIndexSets_[level]->remove(e);
+    }
+
     unsigned int getNextFreeId(int codim) {
       return (codim==0) ? freeElementIdCounter_++ : freeVertexIdCounter_++;
     }
@@ -294,6 +294,7 @@ bool Dune::OneDGrid::adapt()
           assert(leftElementToBeDeleted->father_->vertex_[0]->son_ == leftElementToBeDeleted->vertex_[0]);
           leftElementToBeDeleted->father_->vertex_[0]->son_ = NULL;
 
+          levelIndexSetRemove(i, leftElementToBeDeleted->vertex_[0]);
           vertices(i).erase(leftElementToBeDeleted->vertex_[0]);
         }
 
@@ -305,11 +306,15 @@ bool Dune::OneDGrid::adapt()
           assert(rightElementToBeDeleted->father_->vertex_[1]->son_ == rightElementToBeDeleted->vertex_[1]);
           rightElementToBeDeleted->father_->vertex_[1]->son_ = NULL;
 
+          levelIndexSetRemove(i, rightElementToBeDeleted->vertex_[1]);
           vertices(i).erase(rightElementToBeDeleted->vertex_[1]);
         }
 
         // Delete vertex between left and right element to be deleted
+        // It has no father vertex, so its leaf index disappears as well
         assert(leftElementToBeDeleted->vertex_[1] == rightElementToBeDeleted->vertex_[0]);
+        levelIndexSetRemove(i, leftElementToBeDeleted->vertex_[1]);
+        leafIndexSet_.remove(leftElementToBeDeleted->vertex_[1]);
         vertices(i).erase(leftElementToBeDeleted->vertex_[1]);
 
         // Remove references from the father element
@@ -320,7 +325,14 @@ bool Dune::OneDGrid::adapt()
         // Paranoia: make sure the father is not marked for refinement
         rightElementToBeDeleted->father_->markState_ = OneDEntityImp<1>::DO_NOTHING;
 
+        // The father is a leaf again
+        leafIndexSet_.insert(leftElementToBeDeleted->father_);
+
         // Actually delete elements
+        levelIndexSetRemove(i, leftElementToBeDeleted);
+        levelIndexSetRemove(i, rightElementToBeDeleted);
+        leafIndexSet_.remove(leftElementToBeDeleted);
+        leafIndexSet_.remove(rightElementToBeDeleted);
         elements(i).erase(leftElementToBeDeleted);
         elements(i).erase(rightElementToBeDeleted);
       }
@@ -377,12 +389,16 @@ bool Dune::OneDGrid::adapt()
                                               eIt->vertex_[0]->pos_,
                                               eIt->vertex_[0]->id_);
 
+          // The new vertex is the leaf vertex of its father
+          newLeftUpperVertex.leafIndex_ = eIt->vertex_[0]->leafIndex_;
+
           // Insert new vertex into vertex list
           leftUpperVertex = vertices(i+1).insert((leftNeighbor)
                                                  ? leftNeighbor->sons_[1]->vertex_[1]->succ_
                                                  : vertices(i+1).begin(),
                                                  newLeftUpperVertex);
 
+          levelIndexSetInsert(i+1, leftUpperVertex);
         }
 
         eIt->vertex_[0]->son_ = leftUpperVertex;
@@ -397,6 +413,9 @@ bool Dune::OneDGrid::adapt()
 
         OneDGridList<OneDEntityImp<0> >::iterator centerVertexIterator = vertices(i+1).insert(leftUpperVertex->succ_, centerVertex);
 
+        levelIndexSetInsert(i+1, centerVertexIterator);
+        leafIndexSet_.insert(centerVertexIterator);
+
         // ////////////////////////////////////////////////////////////
         // Does the right vertex exist on the next-higher level?
         // If no create it
@@ -408,8 +427,11 @@ bool Dune::OneDGrid::adapt()
                                                eIt->vertex_[1]->pos_,
                                                eIt->vertex_[1]->id_);
 
+          newRightUpperVertex.leafIndex_ = eIt->vertex_[1]->leafIndex_;
+
           rightUpperVertex = vertices(i+1).insert(centerVertexIterator->succ_, newRightUpperVertex);
 
+          levelIndexSetInsert(i+1, rightUpperVertex);
         }
 
         eIt->vertex_[1]->son_ = rightUpperVertex;
@@ -439,6 +461,13 @@ bool Dune::OneDGrid::adapt()
 
         eIt->sons_[1] = elements(i+1).insert(eIt->sons_[0]->succ_, newElement1);
 
+        // The sons replace their father in the leaf index set
+        levelIndexSetInsert(i+1, eIt->sons_[0]);
+        levelIndexSetInsert(i+1, eIt->sons_[1]);
+        leafIndexSet_.remove(eIt);
+        leafIndexSet_.insert(eIt->sons_[0]);
+        leafIndexSet_.insert(eIt->sons_[1]);
+
         // The grid has been modified
         refinedGrid = true;
 
@@ -475,6 +504,7 @@ bool Dune::OneDGrid::adapt()
           if (leftUpperVertex==NULL) {
 
             OneDEntityImp<0> newLeftUpperVertex(i+1, eIt->vertex_[0]->pos_, eIt->vertex_[0]->id_);
+            newLeftUpperVertex.leafIndex_ = eIt->vertex_[0]->leafIndex_;
 
             // Insert new vertex into vertex list
             leftUpperVertex = vertices(i+1).insert((leftNeighbor)
@@ -482,6 +512,7 @@ bool Dune::OneDGrid::adapt()
                                                    : vertices(i+1).begin(),
                                                    newLeftUpperVertex);
 
+            levelIndexSetInsert(i+1, leftUpperVertex);
           }
 
           eIt->vertex_[0]->son_ = leftUpperVertex;
@@ -493,9 +524,12 @@ bool Dune::OneDGrid::adapt()
           if (rightUpperVertex==NULL) {
 
             OneDEntityImp<0> newRightUpperVertex(i+1, eIt->vertex_[1]->pos_, eIt->vertex_[1]->id_);
+            newRightUpperVertex.leafIndex_ = eIt->vertex_[1]->leafIndex_;
 
             // Insert new vertex into list
             rightUpperVertex = vertices(i+1).insert(leftUpperVertex->succ_, newRightUpperVertex);
+
+            levelIndexSetInsert(i+1, rightUpperVertex);
           }
 
           eIt->vertex_[1]->son_ = rightUpperVertex;
@@ -521,6 +555,10 @@ bool Dune::OneDGrid::adapt()
           // Mark the new element as the sons of the refined element
           eIt->sons_[0] = eIt->sons_[1] = newElementIterator;
 
+          levelIndexSetInsert(i+1, newElementIterator);
+          leafIndexSet_.remove(eIt);
+          leafIndexSet_.insert(newElementIterator);
+
         }
 
       }
@@ -529,9 +567,9 @@ bool Dune::OneDGrid::adapt()
 
   }
 
-  // ////////////////////////////////////
-  //   renumber vertices and elements
-  // ////////////////////////////////////
+  // ////////////////////////////////////////////////////////
+  //   number the new vertices and elements and close holes
+  // ////////////////////////////////////////////////////////
   setIndices();
 
   return refinedGrid;
@@ -7,7 +7,11 @@
     \brief The index and id sets for the OneDGrid class
  */
 
+#include <map>
 #include <vector>
+#include <algorithm>
+
+#include <dune/common/tuples.hh>
 
 #include <dune/grid/common/indexidset.hh>
 
@@ -16,6 +20,159 @@
 
 namespace Dune {
 
+  /** \brief Consecutive numbering of a set of entities which is updated incrementally
+
+     The table stores the entity of each index.  OneDGrid::adapt() reports the
+     entities it creates and removes, and finish() then hands out the indices of
+     the removed entities to the new ones.  Remaining holes are closed by moving
+     the entities with the largest indices, so the cost is proportional to the
+     number of changes and not to the size of the grid.  Entities which are
+     neither created nor removed keep their indices unless they are moved into
+     a hole, indexMap() tells which ones were moved.
+
+     The indices are stored in the entities themselves, Access::get() and
+     Access::set() read and write them.  As long as the table has not been built
+     by numbering all entities with push_back(), changes are ignored.
+   */
+  template <class T, class Access>
+  class OneDGridIncrementalNumbering
+  {
+  public:
+    //! Marks entities which were inserted but have no index yet
+    static const unsigned int pending = ~0u;
+
+    OneDGridIncrementalNumbering() : valid_(false) {}
+
+    //! Number of indices
+    unsigned int size() const {return entity_.size();}
+
+    //! True if the table can be updated incrementally
+    bool valid() const {return valid_;}
+
+    /** \brief The indices changed by the last finish()
+
+       Maps the old index of each entity which has been moved to its current index,
+       and the old index of each removed entity to -1.  All other entities kept their
+       indices.  The map is empty after numbering from scratch.
+     */
+    const std::map<int,int>& indexMap() const {return indexMap_;}
+
+    //! Start numbering all entities from scratch
+    void clear() {
+      entity_.clear();
+      inserted_.clear();
+      removed_.clear();
+      indexMap_.clear();
+      valid_ = true;
+    }
+
+    //! Give the next index to an entity
+    void push_back(T* e) {
+      Access::set(e, entity_.size());
+      entity_.push_back(e);
+    }
+
+    //! Record a new entity
+    void insert(T* e) {
+      if (!valid_)
+        return;
+      Access::set(e, pending);
+      inserted_.push_back(e);
+    }
+
+    //! Record the removal of an entity, to be called before the entity is destroyed
+    void remove(const T* e) {
+      if (!valid_)
+        return;
+      unsigned int index = Access::get(e);
+      if (index == pending)
+        inserted_.erase(std::find(inserted_.begin(), inserted_.end(), e));
+      else
+        removed_.push_back(index);
+    }
+
+    //! Number the recorded new entities and close the holes
+    void finish() {
+      indexMap_.clear();
+      if (inserted_.empty() && removed_.empty())
+        return;
+
+      const unsigned int oldSize = entity_.size();
+      for (size_t i=0; i<removed_.size(); i++)
+        indexMap_[removed_[i]] = -1;
+
+      // reuse the indices of removed entities
+      for (size_t i=0; i<inserted_.size(); i++) {
+        if (removed_.empty())
+          push_back(inserted_[i]);
+        else {
+          entity_[removed_.back()] = inserted_[i];
+          Access::set(inserted_[i], removed_.back());
+          removed_.pop_back();
+        }
+      }
+
+      // move the last entities into the remaining holes
+      std::sort(removed_.begin(), removed_.end());
+      size_t lo = 0, hi = removed_.size();
+      while (lo < hi) {
+        unsigned int last = entity_.size()-1;
+        if (removed_[hi-1] != last) {
+          entity_[removed_[lo]] = entity_[last];
+          Access::set(entity_[last], removed_[lo]);
+          if (last < oldSize)
+            indexMap_[last] = removed_[lo];
+          lo++;
+        } else
+          hi--;
+        entity_.pop_back();
+      }
+
+      inserted_.clear();
+      removed_.clear();
+    }
+
+  private:
+    std::vector<T*> entity_;
+    std::vector<T*> inserted_;
+    std::vector<unsigned int> removed_;
+    std::map<int,int> indexMap_;
+    bool valid_;
+  };
+
+  /** \brief Access to the level index of an entity */
+  template <int mydim>
+  struct OneDGridLevelIndexAccess
+  {
+    static unsigned int get(const OneDEntityImp<mydim>* e) {return e->levelIndex_;}
+    static void set(OneDEntityImp<mydim>* e, unsigned int index) {e->levelIndex_ = index;}
+  };
+
+  /** \brief Access to the leaf index of an element */
+  struct OneDGridLeafElementIndexAccess
+  {
+    static unsigned int get(const OneDEntityImp<1>* e) {return e->leafIndex_;}
+    static void set(OneDEntityImp<1>* e, unsigned int index) {e->leafIndex_ = index;}
+  };
+
+  /** \brief Access to the leaf index of a vertex
+
+     A vertex and all its descendants share the leaf index of the leaf
+     vertex.  The leaf vertex indices are therefore kept for the coarsest
+     vertex of such a column and passed on to the sons.
+   */
+  struct OneDGridLeafVertexIndexAccess
+  {
+    static unsigned int get(const OneDEntityImp<0>* e) {return e->leafIndex_;}
+    static void set(OneDEntityImp<0>* e, unsigned int index) {
+      e->leafIndex_ = index;
+      while (!e->isLeaf()) {
+        e = e->son_;
+        e->leafIndex_ = index;
+      }
+    }
+  };
+
   template<class GridImp>
   class OneDGridLevelIndexSet : public IndexSet<GridImp,OneDGridLevelIndexSet<GridImp> >
   {
@@ -111,36 +268,61 @@ namespace Dune {
 
     }
 
+    /** \brief Record a new entity on this level, it is numbered by the next update() */
+    template <int mydim>
+    void insert(OneDEntityImp<mydim>* e) {
+      Dune::get<mydim>(numbering_).insert(e);
+    }
+
+    /** \brief Record the removal of an entity on this level */
+    template <int mydim>
+    void remove(const OneDEntityImp<mydim>* e) {
+      Dune::get<mydim>(numbering_).remove(e);
+    }
+
     /** \todo Should be private */
     void update() {
 
-      // ///////////////////////////////
-      //   Init the element indices
-      // ///////////////////////////////
-      numElements_ = 0;
-      OneDGridList<OneDEntityImp<1> >::const_iterator eIt;
-      for (eIt = grid_->elements(level_).begin(); eIt != grid_->elements(level_).end(); eIt = eIt->succ_)
-        /** \todo Remove this const cast */
-        const_cast<OneDEntityImp<1>*>(eIt)->levelIndex_ = numElements_++;
-
-      // //////////////////////////////
-      //   Init the vertex indices
-      // //////////////////////////////
-
-      numVertices_ = 0;
-      OneDGridList<OneDEntityImp<0> >::const_iterator vIt;
-      for (vIt = grid_->vertices(level_).begin(); vIt != grid_->vertices(level_).end(); vIt = vIt->succ_)
-        /** \todo Remove this const cast */
-        const_cast<OneDEntityImp<0>*>(vIt)->levelIndex_ = numVertices_++;
+      if (Dune::get<1>(numbering_).valid()) {
+
+        // Only number the entities that were reported by adapt()
+        Dune::get<1>(numbering_).finish();
+        Dune::get<0>(numbering_).finish();
+
+      } else {
+
+        // ///////////////////////////////
+        //   Init the element indices
+        // ///////////////////////////////
+        Dune::get<1>(numbering_).clear();
+        OneDGridList<OneDEntityImp<1> >::const_iterator eIt;
+        for (eIt = grid_->elements(level_).begin(); eIt != grid_->elements(level_).end(); eIt = eIt->succ_)
+          /** \todo Remove this const cast */
+          Dune::get<1>(numbering_).push_back(const_cast<OneDEntityImp<1>*>(eIt));
+
+        // //////////////////////////////
+        //   Init the vertex indices
+        // //////////////////////////////
+        Dune::get<0>(numbering_).clear();
+        OneDGridList<OneDEntityImp<0> >::const_iterator vIt;
+        for (vIt = grid_->vertices(level_).begin(); vIt != grid_->vertices(level_).end(); vIt = vIt->succ_)
+          /** \todo Remove this const cast */
+          Dune::get<0>(numbering_).push_back(const_cast<OneDEntityImp<0>*>(vIt));
+
+      }
 
       // set the list of geometry types
-      setSizesAndTypes(numVertices_, numElements_);
+      setSizesAndTypes(Dune::get<0>(numbering_).size(), Dune::get<1>(numbering_).size());
     }
 
   private:
     const GridImp* grid_;
     int level_;
 
+    /** \brief The index tables for vertices and elements */
+    tuple<OneDGridIncrementalNumbering<OneDEntityImp<0>, OneDGridLevelIndexAccess<0> >,
+        OneDGridIncrementalNumbering<OneDEntityImp<1>, OneDGridLevelIndexAccess<1> > > numbering_;
+
     int numElements_;
     int numVertices_;
 
@@ -261,52 +443,92 @@ namespace Dune {
 
     }
 
-    /** \todo Should be private */
-    void update() {
+    /** \brief Record an element which has become a leaf, it is numbered by the next update() */
+    void insert(OneDEntityImp<1>* e) {
+      elementNumbering_.insert(e);
+    }
 
-      // ///////////////////////////////
-      //   Init the element indices
-      // ///////////////////////////////
-      numElements_ = 0;
-      typename GridImp::Traits::template Codim<0>::LeafIterator eIt    = grid_.template leafbegin<0>();
-      typename GridImp::Traits::template Codim<0>::LeafIterator eEndIt = grid_.template leafend<0>();
+    /** \brief Record an element which is no leaf any more or is removed */
+    void remove(const OneDEntityImp<1>* e) {
+      elementNumbering_.remove(e);
+    }
 
-      for (; eIt!=eEndIt; ++eIt) {
+    /** \brief Record a new vertex which has no father vertex */
+    void insert(OneDEntityImp<0>* v) {
+      vertexNumbering_.insert(v);
+    }
 
-        grid_.getRealImplementation(*eIt).target_->leafIndex_ = numElements_++;
+    /** \brief Record the removal of a vertex which has no father vertex */
+    void remove(const OneDEntityImp<0>* v) {
+      vertexNumbering_.remove(v);
+    }
 
-      }
+    /** \brief Map from the leaf indices before the last adaptation to the current ones, see OneDGrid::leafIndexMap() */
+    const std::map<int,int>& indexMap(int codim) const {
+      return (codim==0) ? elementNumbering_.indexMap() : vertexNumbering_.indexMap();
+    }
 
-      // //////////////////////////////
-      //   Init the vertex indices
-      // //////////////////////////////
+    /** \todo Should be private */
+    void update() {
+
+      if (elementNumbering_.valid()) {
+
+        // Only number the entities that were reported by adapt()
+        elementNumbering_.finish();
+        vertexNumbering_.finish();
+
+      } else {
 
-      numVertices_ = 0;
+        // ///////////////////////////////
+        //   Init the element indices
+        // ///////////////////////////////
+        elementNumbering_.clear();
+        typename GridImp::Traits::template Codim<0>::LeafIterator eIt    = grid_.template leafbegin<0>();
+        typename GridImp::Traits::template Codim<0>::LeafIterator eEndIt = grid_.template leafend<0>();
 
-      for (int i=grid_.maxLevel(); i>=0; i--) {
+        for (; eIt!=eEndIt; ++eIt)
+          elementNumbering_.push_back(grid_.getRealImplementation(*eIt).target_);
 
-        const OneDEntityImp<0>* vIt;
-        for (vIt = grid_.vertices(i).begin(); vIt != grid_.vertices(i).end(); vIt = vIt->succ_) {
+        // //////////////////////////////
+        //   Init the vertex indices
+        // //////////////////////////////
 
-          /** \todo Remove the const casts */
-          if (vIt->isLeaf())
-            const_cast<OneDEntityImp<0>*>(vIt)->leafIndex_ = numVertices_++;
-          else
-            const_cast<OneDEntityImp<0>*>(vIt)->leafIndex_ = vIt->son_->leafIndex_;
+        // A vertex which has not been numbered via its father vertex starts a new column
+        for (int i=0; i<=grid_.maxLevel(); i++) {
+          const OneDEntityImp<0>* vIt;
+          for (vIt = grid_.vertices(i).begin(); vIt != grid_.vertices(i).end(); vIt = vIt->succ_)
+            /** \todo Remove the const casts */
+            const_cast<OneDEntityImp<0>*>(vIt)->leafIndex_ = VertexNumbering::pending;
+        }
 
+        vertexNumbering_.clear();
+        for (int i=0; i<=grid_.maxLevel(); i++) {
+          const OneDEntityImp<0>* vIt;
+          for (vIt = grid_.vertices(i).begin(); vIt != grid_.vertices(i).end(); vIt = vIt->succ_)
+            if (vIt->leafIndex_ == VertexNumbering::pending)
+              vertexNumbering_.push_back(const_cast<OneDEntityImp<0>*>(vIt));
         }
 
       }
 
       // set the list of geometry types
-      setSizesAndTypes(numVertices_, numElements_);
+      setSizesAndTypes(vertexNumbering_.size(), elementNumbering_.size());
 
     }
 
   private:
 
+    typedef OneDGridIncrementalNumbering<OneDEntityImp<1>, OneDGridLeafElementIndexAccess> ElementNumbering;
+    typedef OneDGridIncrementalNumbering<OneDEntityImp<0>, OneDGridLeafVertexIndexAccess> VertexNumbering;
+
     const GridImp& grid_;
 
+    /** \brief The leaf elements by index */
+    ElementNumbering elementNumbering_;
+
+    /** \brief The coarsest vertex of each leaf vertex by index */
+    VertexNumbering vertexNumbering_;
+
     int numElements_;
     int numVertices_;
 
@@ -3,6 +3,9 @@
 #ifndef DUNE_ONEDGRID_LIST_HH
 #define DUNE_ONEDGRID_LIST_HH
 
+#include <new>
+#include <vector>
+
 #include <dune/common/iteratorfacades.hh>
 
 namespace Dune {
@@ -11,6 +14,12 @@ namespace Dune {
       \todo I'd love to get rid of this and use std::list instead.
       Unfortunately, there are problems.  I need to store pointers/iterators
       within one element which point to another element (e.g. the element father).
+
+      The entries are stored in contiguous blocks which are never moved, so
+      pointers to entries stay valid until the entry is erased.  Entries appended
+      to a list are placed one after the other, hence the list order equals the
+      memory order for lists built from left to right, as the coarse grid and
+      the levels created by globalRefine.  Slots of erased entries are reused.
    */
   template<class T>
   class OneDGridListIterator
@@ -52,12 +61,14 @@ namespace Dune {
   template<class T>
   class OneDGridList
   {
+    //! number of entries per block of storage
+    enum { blockSize = 1024 };
 
   public:
     typedef T* iterator;
     typedef const T* const_iterator;
 
-    OneDGridList() : numelements(0), begin_(0), rbegin_(0) {}
+    OneDGridList() : numelements(0), begin_(0), rbegin_(0), used_(blockSize) {}
 
     int size() const {return numelements;}
 
@@ -66,7 +77,7 @@ namespace Dune {
       T* i = rbegin();
 
       // New list element by copy construction
-      T* t = new T(value);
+      T* t = allocate(value);
 
       // einfuegen
       if (begin_==0) {
@@ -101,7 +112,7 @@ namespace Dune {
         return push_back(value);
 
       // New list element by copy construction
-      T* t = new T(value);
+      T* t = allocate(value);
 
       // insert
       if (begin_==0)
@@ -151,7 +162,7 @@ namespace Dune {
       numelements = numelements-1;
 
       // Actually delete the object
-      delete(i);
+      deallocate(i);
     }
 
     iterator begin() {
@@ -180,11 +191,52 @@ namespace Dune {
 
   private:
 
+    //! Copy construct a new entry in the next free slot
+    T* allocate (const T& value)
+    {
+      T* slot;
+      if (!free_.empty()) {
+        slot = free_.back();
+        free_.pop_back();
+      } else {
+        if (used_==blockSize) {
+          blocks_.push_back(static_cast<T*>(::operator new(blockSize*sizeof(T))));
+          used_ = 0;
+        }
+        slot = blocks_.back() + used_++;
+      }
+      return new (slot) T(value);
+    }
+
+    //! Destroy an entry, the storage is released when the list becomes empty
+    void deallocate (T* t)
+    {
+      t->~T();
+      if (numelements>0) {
+        free_.push_back(t);
+        return;
+      }
+      for (size_t k=0; k<blocks_.size(); k++)
+        ::operator delete(blocks_[k]);
+      blocks_.clear();
+      free_.clear();
+      used_ = blockSize;
+    }
+
     int numelements;
 
     T* begin_;
     T* rbegin_;
 
+    //! The storage blocks, each holds blockSize entries
+    std::vector<T*> blocks_;
+
+    //! Number of slots used in the last block
+    int used_;
+
+    //! Slots of erased entries
+    std::vector<T*> free_;
+
   };   // end class OneDGridList
 
 } // namespace Dune
@@ -209,6 +209,14 @@ namespace Dune {
       z(grid->z(l,index,codim)),
       builtgeometry(false) {}
 
+    //! constructor for an entity which is made later
+    explicit SEntityBase (GridImp* _grid) :
+      grid(_grid),
+      l(-1),
+      index(-1),
+      z(),
+      builtgeometry(false) {}
+
     //! empty constructor
     SEntityBase () :
       builtgeometry(false) // mark geometry as not built
@@ -303,6 +311,10 @@ namespace Dune {
     //! constructor
     SEntity (GridImp* _grid, int _l, int _id) :
       SEntityBase(_grid,_l,_id) {}
+
+    //! constructor for an entity which is made later
+    explicit SEntity (GridImp* _grid) :
+      SEntityBase(_grid) {}
   };
 
   /**
@@ -469,8 +481,14 @@ namespace Dune {
       built_father(false)
     {}
 
+    //! constructor for an entity which is made later
+    explicit SEntity (GridImp* _grid) :
+      SEntityBase(_grid),
+      built_father(false)
+    {}
+
     SEntity (const SEntity& other ) :
-      SEntityBase(other.grid, other.l, other.index ),
+      SEntityBase(other),
       built_father(false)
     {}
 
@@ -507,11 +525,13 @@ namespace Dune {
      This is redundant but important for memory efficient implementations of unstructured
      hierarchically refined meshes.
    */
+  template<int dim>
   struct SHierarchicStackElem {
     int l;
     int index;
+    array<int,dim> zred;   //!< reduced coordinates of the element
     SHierarchicStackElem () : l(-1), index(-1) {}
-    SHierarchicStackElem (int _l, int _index) {l=_l; index=_index;}
+    SHierarchicStackElem (int _l, int _index, const array<int,dim>& _zred) : l(_l), index(_index), zred(_zred) {}
     bool operator== (const SHierarchicStackElem& s) const {return !operator!=(s);}
     bool operator!= (const SHierarchicStackElem& s) const {return l!=s.l || index!=s.index;}
   };
@@ -528,6 +548,8 @@ namespace Dune {
     using SEntityPointer::grid;
     using SEntityPointer::l;
     using SEntityPointer::index;
+    using SEntityPointer::builtentity;
+    typedef SHierarchicStackElem<dim> StackElem;
   public:
     typedef typename GridImp::template Codim<0>::Entity Entity;
     typedef typename GridImp::ctype ctype;
@@ -551,18 +573,18 @@ namespace Dune {
       if (makeend) return;
 
       // remember element where begin has been called
-      orig_l = this->entity().level();
-      orig_index = _grid->getRealImplementation(this->entity()).compressedIndex();
+      orig_l = _e.level();
+      orig_index = _e.compressedIndex();
 
       // push original element on stack
-      SHierarchicStackElem originalElement(orig_l, orig_index);
+      StackElem originalElement(orig_l, orig_index, _grid->compress(orig_l,_e.z));
       stack.push(originalElement);
 
       // compute maxLevel
       maxLevel = std::min(_maxLevel,this->grid->maxLevel());
 
       // ok, push all the sons as well
-      push_sons(orig_l,orig_index);
+      push_sons(originalElement);
 
       // and pop the first son
       increment();
@@ -573,9 +595,9 @@ namespace Dune {
     int orig_l, orig_index;       //!< element where begin was called (the root of the tree to be processed)
 
     //!< stack holding elements to be processed
-    std::stack<SHierarchicStackElem, Dune::ReservedVector<SHierarchicStackElem,GridImp::MAXL> > stack;
+    std::stack<StackElem, Dune::ReservedVector<StackElem,GridImp::MAXL> > stack;
 
-    void push_sons (int level, int fatherid); //!< push all sons of this element on the stack
+    void push_sons (const StackElem& father); //!< push all sons of this element on the stack
   };
 
   //************************************************************************
@@ -868,24 +890,6 @@ namespace Dune {
 
   //************************************************************************
 
-  /** \brief a stack of pointers with auto destruction if the stack is
-      destructed
-   */
-  template <class T>
-  class AutoPtrStack : public std::stack<T*>
-  {
-  public:
-    ~AutoPtrStack()
-    {
-      while(! this->empty())
-      {
-        T* e = this->top();
-        delete e;
-        this->pop();
-      }
-    }
-  };
-
   /*! Acts as a pointer to an  entities of a given codimension.
    */
   template<int codim, class GridImp>
@@ -909,31 +913,24 @@ namespace Dune {
     //! constructor
     SEntityPointer (GridImp * _grid, int _l, int _index) :
       grid(_grid), l(_l), index(_index),
-      e(0)
+      e(SEntity<codim,dim,GridImp>(_grid)),
+      builtentity(false)
     {}
 
     //! constructor
     SEntityPointer (const SEntity<codim,dim,GridImp> & _e) :
       grid(_e.grid), l(_e.l), index(_e.index),
-      e(0)
+      e(_e),
+      builtentity(true)
     {}
 
     //! constructor
     SEntityPointer (const SEntityPointer<codim,GridImp>& other) :
       grid(other.grid), l(other.l), index(other.index),
-      e( 0 )
+      e(other.e),
+      builtentity(other.builtentity)
     {}
 
-    //! destructor pointer
-    ~SEntityPointer()
-    {
-      if( e )
-        enStack().push( e );
-#ifndef NDEBUG
-      index = -1;
-#endif
-    }
-
     //! assignment operator
     SEntityPointer& operator = (const SEntityPointer& other)
     {
@@ -941,10 +938,8 @@ namespace Dune {
       l = other.l;
       index = other.index;
 
-      // free current entity
-      if( e )
-        enStack().push( e );
-      e = 0;
+      // the entity is made on the next dereference
+      builtentity = false;
 
       return *this;
     }
@@ -957,42 +952,19 @@ namespace Dune {
 
     inline Entity& entity() const
     {
-      if( ! e )
-      {
-        e = getEntity( grid, l, index );
-      }
-      return *e;
-    }
-
-    typedef AutoPtrStack< Entity > EntityStackType;
-    static inline EntityStackType& enStack()
-    {
-      static EntityStackType eStack;
-      return eStack;
-    }
-
-    inline Entity* getEntity(GridImp* _grid, int _l, int _id ) const
-    {
-      // get stack reference
-      EntityStackType& enSt = enStack();
-
-      if( enSt.empty() )
+      if( ! builtentity )
       {
-        return (new Entity(SEntity<codim,dim,GridImp>(_grid, _l, _id)));
-      }
-      else
-      {
-        Entity* e = enSt.top();
-        enSt.pop();
-        grid->getRealImplementation(*e).make(_grid, _l,_id);
-        return e;
+        grid->getRealImplementation(e).make( grid, l, index );
+        builtentity = true;
       }
+      return e;
     }
 
     GridImp* grid;               //!< my grid
     int l;                       //!< level where element is on
     mutable int index;           //!< my consecutive index
-    mutable Entity* e;           //!< virtual entity
+    mutable Entity e;            //!< my entity, is only made on dereference
+    mutable bool builtentity;    //!< true if e is the entity (l,index)
   };
 
   /*! describes the minimal information necessary to create a fully functional SEntity
@@ -1032,6 +1004,7 @@ namespace Dune {
     using SEntityPointer::realEntity;
     using SEntityPointer::l;
     using SEntityPointer::index;
+    using SEntityPointer::builtentity;
   public:
     typedef typename GridImp::template Codim<codim>::Entity Entity;
 
@@ -1577,6 +1550,9 @@ namespace Dune {
     //! given reduced coordinates of an element, determine if element is in the grid
     bool exists (int level, const array<int,dim>& zred) const;
 
+    //! change of the element number for a unit step of the reduced coordinate in direction i
+    int cellstride (int level, int i) const;
+
     // compute boundary segment index for a given zentity and a face
     int boundarySegmentIndex (int l, int face, const array<int,dim> & zentity) const
     {
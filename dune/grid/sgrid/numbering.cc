@@ -44,6 +44,12 @@ namespace Dune {
     return z;
   }
 
+  template<int dim>
+  inline int LexOrder<dim>::stride (int i) const
+  {
+    return P[i];
+  }
+
   //************************************************************************
 
   template<int dim>
@@ -251,6 +257,12 @@ namespace Dune {
     return r;
   }
 
+  template<int dim>
+  inline int CubeMapper<dim>::stride (int b, int i) const
+  {
+    return lex[b].stride(i);
+  }
+
   template<int dim>
   inline array<int,dim> CubeMapper<dim>::compress (const array<int,dim>& z) const
   {
@@ -23,6 +23,9 @@ namespace Dune {
     //! compute tupel from number 0 <= n < tupels()
     array<int,dim> z (int n) const;
 
+    //! change of the number for a unit step in direction i
+    int stride (int i) const;
+
   private:
     array<int,dim> N; // number of elements per direction
     int P[dim+1];     // P[i] = Prod_{i=0}^{i} N[i];
@@ -112,6 +115,9 @@ namespace Dune {
     //! There are \f$2^d\f$ possibilities of having even/odd coordinates. The binary representation is called partition number
     int partition (const array<int,dim>& z) const;
 
+    //! change of the number for a unit step of the compressed coordinate in direction i within partition b
+    int stride (int b, int i) const;
+
     //! print internal data
     void print (std::ostream& ss, int indent) const;
 
@@ -222,33 +222,34 @@ namespace Dune {
   // inline methods for HierarchicIterator
 
   template<class GridImp>
-  inline void SHierarchicIterator<GridImp>::push_sons (int level, int fatherid)
+  inline void SHierarchicIterator<GridImp>::push_sons (const StackElem& father)
   {
     // check level
-    if (level+1>maxLevel) return;     // nothing to do
+    if (father.l+1>maxLevel) return;     // nothing to do
 
-    // compute reduced coordinates of element
-    array<int,dim> z =
-      grid->z(level,fatherid,0);      // expanded coordinates from index
-    array<int,dim> zred =
-      grid->compress(level,z);     // reduced coordinates from expaned coordinates
-
-    // refine to first son
-    for (int i=0; i<dim; i++) zred[i] = 2*zred[i];
+    // refine to first son, the reduced coordinates of the sons
+    // are numbered lexicographically on level l+1
+    StackElem first(father.l+1,0,father.zred);
+    array<int,dim> stride;
+    for (int i=0; i<dim; i++)
+    {
+      stride[i] = grid->cellstride(first.l,i);
+      first.zred[i] = 2*father.zred[i];
+      first.index += first.zred[i]*stride[i];
+    }
 
     // generate all \f$2^{dim}\f$ sons
-    int partition = grid->partition(level,z);
     for (int b=0; b<(1<<dim); b++)
     {
-      array<int,dim> zz = zred;
+      StackElem son = first;
       for (int i=0; i<dim; i++)
-        if (b&(1<<i)) zz[i] += 1;
-      // zz is reduced coordinate of a son on level level+1
-      int sonid = grid->n(level+1,grid->expand(level+1,zz,partition));
+        if (b&(1<<i))
+        {
+          son.zred[i] += 1;
+          son.index += stride[i];
+        }
 
       // push son on stack
-      SHierarchicStackElem son(level+1,sonid);
-      //stack.push(StackElem(level+1,sonid));
       stack.push(son);
     }
   }
@@ -260,15 +261,15 @@ namespace Dune {
     if (stack.empty()) return;
 
     // OK, lets pop
-    SHierarchicStackElem newe = stack.top();
+    StackElem newe = stack.top();
     stack.pop();
     l = newe.l;
     index = newe.index;
-    realEntity().make(l,index);     // here is our new element
+    builtentity = false;     // here is our new element
 
     // push all sons of this element if it is not the original element
     if (newe.l!=orig_l || newe.index!=orig_index)
-      push_sons(newe.l,newe.index);
+      push_sons(newe);
   }
 
   //************************************************************************
@@ -286,9 +287,10 @@ namespace Dune {
     count = _count;
 
     // check if count is valid
-    if (count<0 || count>=grid->getRealImplementation(self).entity().template count<1>())
+    if (count<0 || count>=2*dim)
     {
       grid->getRealImplementation(ne).index = -1;
+      grid->getRealImplementation(ne).builtentity = false;
       return;   // done, this is end iterator
     }
     valid_count = true;
@@ -302,17 +304,15 @@ namespace Dune {
     if (is_on_boundary)
     {
       grid->getRealImplementation(ne).index = -1;
+      grid->getRealImplementation(ne).builtentity = false;
       return;   // ok, done it
     }
 
     // now neighbor is in the grid and must be initialized.
-    // First compute its index
-    grid->getRealImplementation(ne).index =
-      grid->n(grid->getRealImplementation(self).l,
-              grid->expand(grid->getRealImplementation(self).l,zrednb,partition));
-    grid->getRealImplementation(ne).realEntity().make(
-      grid->getRealImplementation(ne).l,
-      grid->getRealImplementation(ne).index);
+    // Its index differs from ours by the stride of the direction
+    grid->getRealImplementation(ne).index = grid->getRealImplementation(self).index
+                                            + (-1+2*(count%2))*grid->cellstride(grid->getRealImplementation(self).l,count/2);
+    grid->getRealImplementation(ne).builtentity = false;
   }
 
   template<class GridImp>
@@ -477,7 +477,7 @@ namespace Dune {
   inline void SLevelIterator<codim,pitype,GridImp>::increment ()
   {
     ++index;
-    realEntity().make(l,index);
+    builtentity = false;
   }
 
   //************************************************************************
@@ -759,6 +759,12 @@ namespace Dune {
     return mapper[level].partition(z);
   }
 
+  template<int dim, int dimworld, typename ctype>
+  inline int SGrid<dim,dimworld,ctype>::cellstride (int level, int i) const
+  {
+    return mapper[level].stride(0,i);
+  }
+
   template<int dim, int dimworld, typename ctype>
   inline bool SGrid<dim,dimworld,ctype>::exists (int level, const array<int,dim>& zred) const
   {
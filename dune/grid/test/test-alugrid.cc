@@ -7,9 +7,13 @@
 
 #define DISABLE_DEPRECATED_METHOD_CHECK 1
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <dune/common/tupleutility.hh>
 #include <dune/common/tuples.hh>
@@ -394,6 +398,178 @@ void checkLevelIndexNonConform(GridType & grid)
   }
 }
 
+// the face geometry cache only exists for the 3d grids
+template <class GridType, int dim = GridType :: dimension>
+struct FaceGeometryCachingCheck
+{
+  static void check ( GridType & grid ) {}
+};
+
+template <class GridType>
+struct FaceGeometryCachingCheck< GridType, 3 >
+{
+  typedef typename GridType :: ctype ctype;
+  typedef FieldVector< ctype, 3 > VectorType;
+
+  // store the local geometries and normals of all leaf intersections in data
+  static void collect ( const GridType & grid, std::vector< VectorType > & data )
+  {
+    typedef typename GridType :: LeafGridView GridView;
+    typedef typename GridView :: template Codim< 0 > :: Iterator Iterator;
+    typedef typename GridView :: IntersectionIterator IntersectionIterator;
+
+    const GridView gridView = grid.leafView();
+    data.clear();
+    const Iterator end = gridView.template end< 0 >();
+    for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
+    {
+      const IntersectionIterator iend = gridView.iend( *it );
+      for( IntersectionIterator iit = gridView.ibegin( *it ); iit != iend; ++iit )
+      {
+        const typename IntersectionIterator :: Intersection & intersection = *iit;
+        const FieldVector< ctype, 2 > &center
+          = ReferenceElements< ctype, 2 > :: general( intersection.type() ).position( 0, 0 );
+        data.push_back( intersection.geometryInInside().center() );
+        data.push_back( intersection.outerNormal( center ) );
+        data.push_back( intersection.integrationOuterNormal( center ) );
+        if( intersection.neighbor() )
+          data.push_back( intersection.geometryInOutside().center() );
+      }
+    }
+  }
+
+  // compare the data computed with and without the face geometry cache
+  static void compare ( const std::vector< VectorType > & data, const std::vector< VectorType > & expected )
+  {
+    if( data.size() != expected.size() )
+      DUNE_THROW( GridError, "face geometry cache changes the number of intersections" );
+    for( size_t i = 0; i < data.size(); ++i )
+    {
+      if( (data[ i ] - expected[ i ]).two_norm() > 1e-8 )
+        DUNE_THROW( GridError, "face geometry cache returns " << data[ i ] << " instead of " << expected[ i ] );
+    }
+  }
+
+  // collect the data twice, the first sweep fills the cache, the second one uses it
+  static void compare ( const GridType & grid, const std::vector< VectorType > & expected )
+  {
+    std::vector< VectorType > data;
+    collect( grid, data );
+    compare( data, expected );
+    collect( grid, data );
+    compare( data, expected );
+  }
+
+  static void check ( GridType & grid )
+  {
+    std::cout << "  CHECKING: face geometry cache" << std::endl;
+    std::vector< VectorType > expected;
+    collect( grid, expected );
+
+    grid.setFaceGeometryCaching( true );
+    compare( grid, expected );
+
+    // the cache stays switched on, so it has to be invalidated by the adaptation itself
+    makeNonConfGrid( grid, 0, 1 );
+    std::vector< VectorType > cached, data;
+    collect( grid, cached );
+    collect( grid, data );
+
+    grid.setFaceGeometryCaching( false );
+    collect( grid, expected );
+    compare( cached, expected );
+    compare( data, expected );
+  }
+};
+
+// the batched evaluation of the mappings only exists for the 3d hexahedral grids
+template <class GridType, int dim = GridType :: dimension>
+struct BatchedMappingCheck
+{
+  static void check ( const GridType & grid ) {}
+};
+
+template <class GridType>
+struct BatchedMappingCheck< GridType, 3 >
+{
+  typedef typename GridType :: ctype ctype;
+
+  // compare the batched values with those of the pointwise methods
+  template <class Mapping, class Local, int mydim>
+  static void compare ( Mapping & mapping, const std::vector< Local > & points,
+                        const MappingBatch< mydim, 3 > & values )
+  {
+    for( size_t p = 0; p < points.size(); ++p )
+    {
+      FieldVector< ctype, 3 > global;
+      mapping.map2world( points[ p ], global );
+      double error = std::abs( mapping.det( points[ p ] ) - values.integrationElement[ p ] );
+      const FieldMatrix< ctype, 3, mydim > jit = mapping.jacobianInverseTransposed( points[ p ] );
+      for( int i = 0; i < 3; ++i )
+      {
+        error = std::max( error, std::abs( global[ i ] - values.global[ i ][ p ] ) );
+        for( int j = 0; j < mydim; ++j )
+          error = std::max( error, std::abs( jit[ i ][ j ] - values.jacobianInverseTransposed[ i ][ j ][ p ] ) );
+      }
+      if( error > 1e-8 )
+        DUNE_THROW( GridError, "batched mapping differs by " << error << " at point " << p );
+    }
+  }
+
+  static void check ( const GridType & grid )
+  {
+    if( ! grid.geomTypes( 0 )[ 0 ].isCube() )
+      return;
+    std::cout << "  CHECKING: batched mappings" << std::endl;
+
+    typedef typename GridType :: LeafGridView GridView;
+    typedef typename GridView :: template Codim< 0 > :: Iterator Iterator;
+    typedef typename GridView :: IntersectionIterator IntersectionIterator;
+
+    // a tensor grid of points in the reference cube and square
+    std::vector< FieldVector< ctype, 3 > > points;
+    std::vector< FieldVector< ctype, 2 > > facePoints;
+    for( int k = 0; k < 4; ++k )
+    {
+      for( int j = 0; j < 4; ++j )
+      {
+        FieldVector< ctype, 2 > x;
+        x[ 0 ] = 0.1 + 0.25*j; x[ 1 ] = 0.1 + 0.25*k;
+        facePoints.push_back( x );
+        for( int i = 0; i < 4; ++i )
+        {
+          FieldVector< ctype, 3 > y;
+          y[ 0 ] = 0.1 + 0.25*i; y[ 1 ] = x[ 0 ]; y[ 2 ] = x[ 1 ];
+          points.push_back( y );
+        }
+      }
+    }
+
+    const GridView gridView = grid.leafView();
+    MappingBatch< 3, 3 > values;
+    MappingBatch< 2, 3 > faceValues;
+    const Iterator end = gridView.template end< 0 >();
+    for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
+    {
+      const typename Iterator :: Entity :: Geometry geo = it->geometry();
+      TrilinearMapping mapping( geo.corner( 0 ), geo.corner( 1 ), geo.corner( 2 ), geo.corner( 3 ),
+                                geo.corner( 4 ), geo.corner( 5 ), geo.corner( 6 ), geo.corner( 7 ) );
+      mapping.evaluate( points, values );
+      compare( mapping, points, values );
+
+      const IntersectionIterator iend = gridView.iend( *it );
+      for( IntersectionIterator iit = gridView.ibegin( *it ); iit != iend; ++iit )
+      {
+        const typename IntersectionIterator :: Intersection :: Geometry faceGeo = iit->geometry();
+        BilinearSurfaceMapping faceMapping( faceGeo.corner( 0 ), faceGeo.corner( 1 ),
+                                            faceGeo.corner( 2 ), faceGeo.corner( 3 ) );
+        faceMapping.evaluate( facePoints, faceValues );
+        compare( faceMapping, facePoints, faceValues );
+      }
+    }
+  }
+};
+
 template <class GridView>
 void writeFile( const GridView& gridView )
 {
@@ -495,15 +671,61 @@ void checkALUSerial(GridType & grid, int mxl = 2, const bool display = false)
   // check persistent container
   checkPersistentContainer( grid );
 
+  // check the cached geometries of the leaf intersections
+  FaceGeometryCachingCheck< GridType > :: check( grid );
+
+  // check the batched evaluation of the mappings
+  BatchedMappingCheck< GridType > :: check( grid );
+
   std::cout << std::endl << std::endl;
 }
 
+// weight of a macro element, the number of its leaf children
+struct LeafChildrenWeight
+{
+  template <class Element>
+  double operator() ( const Element & element ) const
+  {
+    typedef typename Element :: HierarchicIterator HierarchicIterator;
+    double weight = 0;
+    const int maxLevel = std::numeric_limits< int > :: max();
+    const HierarchicIterator end = element.hend( maxLevel );
+    for( HierarchicIterator it = element.hbegin( maxLevel ); it != end; ++it )
+      if( it->isLeaf() )
+        ++weight;
+    return std::max( weight, 1.0 );
+  }
+};
+
+// the weighted imbalance has to agree on all processes
+template <class GridType>
+void checkWeightedLoadBalance(GridType & grid)
+{
+  const double imbalance = grid.weightedImbalance( LeafChildrenWeight() );
+  if( grid.comm().max( imbalance ) != grid.comm().min( imbalance ) )
+    DUNE_THROW( GridError, "weighted imbalance differs between the processes" );
+  if( imbalance < 1.0 - 1e-12 )
+    DUNE_THROW( GridError, "imbalance " << imbalance << " is smaller than one" );
+  if( grid.comm().rank() == 0 )
+    std::cout << "Weighted imbalance " << imbalance << std::endl;
+
+  // with a large tolerance nothing is moved
+  double current = 0;
+  const int leafElements = grid.size( 0 );
+  if( grid.loadBalanceIfImbalanced( LeafChildrenWeight(), imbalance, current ) || grid.size( 0 ) != leafElements )
+    DUNE_THROW( GridError, "grid was repartitioned although the load is within the tolerance" );
+  if( current != imbalance )
+    DUNE_THROW( GridError, "load balancing saw imbalance " << current << " instead of " << imbalance );
+}
+
 template <class GridType>
 void checkALUParallel(GridType & grid, int gref, int mxl = 3)
 {
 #if USE_PARALLEL_TEST
   makeNonConfGrid(grid,gref,mxl);
 
+  checkWeightedLoadBalance( grid );
+
   // check iterators
   checkIterators( grid );
 
@@ -0,0 +1,176 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <iostream>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/alugrid/common/memory.hh>
+
+/*
+
+   Check the thread pools of the ALUMemoryProvider.  The provider does not
+   need the ALUGrid library, so this test is always built.  Compiled with
+   OpenMP it also frees objects in other threads than the ones that got them.
+
+ */
+
+using namespace Dune;
+
+// an object that counts its instances
+struct CountedObject
+{
+  static int instances;
+
+  CountedObject ()
+  {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    ++instances;
+  }
+
+  ~CountedObject ()
+  {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    --instances;
+  }
+};
+
+int CountedObject::instances = 0;
+
+typedef ALUMemoryProvider< CountedObject > Provider;
+
+void checkInstances ( size_t expected, const char *when )
+{
+  if( CountedObject::instances < 0 || size_t( CountedObject::instances ) != expected )
+    DUNE_THROW( InvalidStateException, CountedObject::instances << " objects exist " << when
+                                                                << " instead of " << expected );
+}
+
+void checkPoolSize ( const Provider &provider, int thread, size_t expected, const char *when )
+{
+  if( provider.poolSize( thread ) != expected )
+    DUNE_THROW( InvalidStateException, "the pool of thread " << thread << " has " << provider.poolSize( thread )
+                                                             << " objects " << when << " instead of " << expected );
+}
+
+// get and free objects in one thread
+void checkSingleThread ()
+{
+  Provider provider;
+  const size_t n = 10;
+
+  std::vector< CountedObject * > objects( n );
+  for( size_t i = 0; i < n; ++i )
+    objects[ i ] = provider.getEmptyObject();
+  checkInstances( n, "after getting objects" );
+
+  for( size_t i = 0; i < n; ++i )
+    provider.freeObject( objects[ i ] );
+  checkPoolSize( provider, 0, n, "after freeing" );
+  checkInstances( n, "after freeing" );
+
+  // freed objects are reused
+  for( size_t i = 0; i < n; ++i )
+    objects[ i ] = provider.getEmptyObject();
+  checkPoolSize( provider, 0, 0, "after reusing" );
+  checkInstances( n, "after reusing" );
+
+  // a full pool deletes further objects
+  const size_t many = Provider::maxPoolSize() + n;
+  objects.resize( many );
+  for( size_t i = n; i < many; ++i )
+    objects[ i ] = provider.getEmptyObject();
+  for( size_t i = 0; i < many; ++i )
+    provider.freeObject( objects[ i ] );
+  checkPoolSize( provider, 0, Provider::maxPoolSize(), "after overflowing" );
+  checkInstances( Provider::maxPoolSize(), "after overflowing" );
+}
+
+#ifdef _OPENMP
+// every thread gets objects, and the next thread frees them
+void checkThreads ()
+{
+  Provider provider;
+  const int maxThreads = ALUGridThreads::maxThreads();
+  const size_t n = 100;
+  const size_t many = Provider::maxPoolSize() + n;
+
+  std::vector< std::vector< CountedObject * > > objects( maxThreads );
+  int threads = 0;
+
+#pragma omp parallel num_threads( maxThreads )
+  {
+    const int thread = ALUGridThreads::threadNumber();
+#pragma omp single
+    threads = omp_get_num_threads();
+
+    // get new objects in this thread
+    objects[ thread ].resize( n );
+    for( size_t i = 0; i < n; ++i )
+      objects[ thread ][ i ] = provider.getEmptyObject();
+#pragma omp barrier
+
+    // free the objects of the previous thread
+    const int previous = (thread + threads - 1) % threads;
+    for( size_t i = 0; i < n; ++i )
+      provider.freeObject( objects[ previous ][ i ] );
+  }
+
+  for( int thread = 0; thread < threads; ++thread )
+    checkPoolSize( provider, thread, n, "after freeing in another thread" );
+  checkInstances( threads*n, "after freeing in another thread" );
+
+#pragma omp parallel num_threads( threads )
+  {
+    const int thread = ALUGridThreads::threadNumber();
+
+    // each thread reuses the objects in its own pool and gets more than a pool holds
+    objects[ thread ].resize( many );
+    for( size_t i = 0; i < many; ++i )
+      objects[ thread ][ i ] = provider.getEmptyObject();
+#pragma omp barrier
+
+    // the next thread frees them, and its pool overflows
+    const int previous = (thread + threads - 1) % threads;
+    for( size_t i = 0; i < many; ++i )
+      provider.freeObject( objects[ previous ][ i ] );
+  }
+
+  for( int thread = 0; thread < threads; ++thread )
+    checkPoolSize( provider, thread, Provider::maxPoolSize(), "after overflowing in another thread" );
+  checkInstances( threads*Provider::maxPoolSize(), "after overflowing in another thread" );
+
+  std::cout << threads << " threads exchanged objects through the memory provider" << std::endl;
+}
+#endif
+
+int main ( int argc, char **argv )
+try
+{
+  checkSingleThread();
+  checkInstances( 0, "after destroying the provider" );
+
+#ifdef _OPENMP
+  checkThreads();
+  checkInstances( 0, "after destroying the provider" );
+#endif
+
+  return 0;
+}
+catch( const Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
+catch( ... )
+{
+  std::cerr << "Generic exception!" << std::endl;
+  return 2;
+}
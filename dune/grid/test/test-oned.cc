@@ -4,8 +4,10 @@
 
 #include <config.h>
 
+#include <algorithm>
 #include <vector>
 #include <memory>
+#include <map>
 
 #include <dune/grid/onedgrid.hh>
 
@@ -162,6 +164,145 @@ void testOneDGrid(OneDGrid& grid)
   checkAdaptation( grid );
 }
 
+// the current index of an entity with the given old index, according to the sparse index map
+int mappedIndex(const std::map<int,int>& indexMap, int index)
+{
+  std::map<int,int>::const_iterator it = indexMap.find(index);
+  return (it==indexMap.end()) ? index : it->second;
+}
+
+// Leaf indices of elements untouched by adapt() have to be kept or reported by leafIndexMap()
+template <class Marker>
+void adaptAndCheckIndexMap(OneDGrid& grid, const Marker& marker)
+{
+  typedef OneDGrid::LeafGridView GridView;
+  typedef GridView::Codim<0>::Iterator Iterator;
+  typedef OneDGrid::LocalIdSet::IdType IdType;
+
+  const GridView gridView = grid.leafView();
+  const OneDGrid::LocalIdSet& idSet = grid.localIdSet();
+
+  std::map<IdType, int> oldIndex;
+  for (Iterator it = gridView.begin<0>(); it != gridView.end<0>(); ++it) {
+    oldIndex[idSet.id(*it)] = gridView.indexSet().index(*it);
+    grid.mark(marker(*it), *it);
+  }
+  const int oldSize = gridView.size(0);
+
+  grid.preAdapt();
+  grid.adapt();
+  grid.postAdapt();
+
+  const std::map<int,int>& indexMap = grid.leafIndexMap(0);
+  if (!indexMap.empty() && (indexMap.begin()->first<0 || indexMap.rbegin()->first>=oldSize))
+    DUNE_THROW(GridError, "Leaf index map contains indices outside of [0," << oldSize << ")");
+
+  // elements which are still in the leaf grid
+  std::vector<bool> kept(oldSize, false);
+  int moved = 0;
+  for (Iterator it = gridView.begin<0>(); it != gridView.end<0>(); ++it) {
+    std::map<IdType, int>::const_iterator old = oldIndex.find(idSet.id(*it));
+    if (old==oldIndex.end())
+      continue;
+    kept[old->second] = true;
+    if (mappedIndex(indexMap, old->second)!=gridView.indexSet().index(*it))
+      DUNE_THROW(GridError, "Leaf index map sends " << old->second << " to " << mappedIndex(indexMap, old->second)
+                                                    << " instead of " << gridView.indexSet().index(*it));
+    if (old->second!=gridView.indexSet().index(*it))
+      moved++;
+  }
+  int removed = 0;
+  for (int i=0; i<oldSize; i++)
+    if (!kept[i]) {
+      removed++;
+      if (mappedIndex(indexMap, i)!=-1)
+        DUNE_THROW(GridError, "Leaf index map keeps the removed index " << i);
+    }
+
+  // the map only holds the changes
+  if (int(indexMap.size())!=moved+removed)
+    DUNE_THROW(GridError, "Leaf index map has " << indexMap.size() << " entries for "
+                                                << moved << " moved and " << removed << " removed elements");
+
+  // only the holes left behind by shrinking the index range need to be closed
+  const int holes = std::max(oldSize - gridView.size(0), 0);
+  if (moved > holes)
+    DUNE_THROW(GridError, moved << " kept elements got new leaf indices, but only " << holes << " holes had to be closed");
+}
+
+// refine the elements with the given ids
+struct RefineMarker
+{
+  RefineMarker(const OneDGrid& grid, OneDGrid::LocalIdSet::IdType id) : idSet_(grid.localIdSet()), id_(id) {}
+
+  int operator() (const OneDGrid::Codim<0>::Entity& e) const {
+    return (idSet_.id(e)==id_) ? 1 : 0;
+  }
+
+  const OneDGrid::LocalIdSet& idSet_;
+  OneDGrid::LocalIdSet::IdType id_;
+};
+
+// coarsen the sons of the element with the given id
+struct CoarsenMarker
+{
+  CoarsenMarker(const OneDGrid& grid, OneDGrid::LocalIdSet::IdType id) : idSet_(grid.localIdSet()), id_(id) {}
+
+  int operator() (const OneDGrid::Codim<0>::Entity& e) const {
+    return (e.level()>0 && idSet_.id(*e.father())==id_) ? -1 : 0;
+  }
+
+  const OneDGrid::LocalIdSet& idSet_;
+  OneDGrid::LocalIdSet::IdType id_;
+};
+
+// Refine A, refine B, coarsen A, and follow the leaf indices of all other elements
+void checkIncrementalIndexUpdate(OneDGrid& grid)
+{
+  typedef OneDGrid::LeafGridView GridView;
+  typedef GridView::Codim<0>::Iterator Iterator;
+  typedef OneDGrid::LocalIdSet::IdType IdType;
+
+  const GridView gridView = grid.leafView();
+  const OneDGrid::LocalIdSet& idSet = grid.localIdSet();
+  const int oldSize = gridView.size(0);
+
+  const IdType idA = idSet.id(*gridView.begin<0>());
+  IdType idB = idA;
+  for (Iterator it = gridView.begin<0>(); it != gridView.end<0>(); ++it)
+    idB = idSet.id(*it);
+  if (idA==idB)
+    DUNE_THROW(GridError, "checkIncrementalIndexUpdate needs at least two leaf elements");
+
+  adaptAndCheckIndexMap(grid, RefineMarker(grid, idA));
+  adaptAndCheckIndexMap(grid, RefineMarker(grid, idB));
+
+  // the sons of B are untouched by the coarsening of A
+  std::map<IdType, int> indexB;
+  for (Iterator it = gridView.begin<0>(); it != gridView.end<0>(); ++it)
+    if (it->level()>0 && idSet.id(*it->father())==idB)
+      indexB[idSet.id(*it)] = gridView.indexSet().index(*it);
+
+  adaptAndCheckIndexMap(grid, CoarsenMarker(grid, idA));
+
+  const std::map<int,int>& indexMap = grid.leafIndexMap(0);
+  for (Iterator it = gridView.begin<0>(); it != gridView.end<0>(); ++it)
+    if (indexB.count(idSet.id(*it)) && mappedIndex(indexMap, indexB[idSet.id(*it)])!=gridView.indexSet().index(*it))
+      DUNE_THROW(GridError, "Leaf index map does not follow the sons of B");
+
+  adaptAndCheckIndexMap(grid, CoarsenMarker(grid, idB));
+
+  // nothing marked, nothing changes
+  adaptAndCheckIndexMap(grid, CoarsenMarker(grid, idB));
+  if (!grid.leafIndexMap(0).empty())
+    DUNE_THROW(GridError, "Leaf index map is not empty after an adaptation without changes");
+
+  if (gridView.size(0)!=oldSize)
+    DUNE_THROW(GridError, "Refining and coarsening elements has changed the number of leaf elements!");
+
+  gridcheck(grid);
+}
+
 int main () try
 {
   // Create a OneDGrid using the grid factory and test it
@@ -182,6 +323,8 @@ int main () try
 
   testOneDGrid(coordsGrid);
 
+  checkIncrementalIndexUpdate(coordsGrid);
+
   // Create a uniform OneDGrid and test it
   Dune::OneDGrid uniformGrid(7,       // Number of elements
                              -0.5,    // Left boundary
@@ -6,7 +6,11 @@
 #include <config.h>
 
 #include <unistd.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <set>
+#include <sstream>
 #include <vector>
 
 #include <dune/grid/uggrid.hh>
@@ -15,6 +19,7 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/common/float_cmp.hh>
 #include <dune/grid/common/gridenums.hh>
+#include <dune/grid/utility/graphpartitioner.hh>
 #include <dune/grid/utility/structuredgridfactory.hh>
 #include <dune/geometry/referenceelements.hh>
 
@@ -315,6 +320,94 @@ void testCommunication(const GridView &gridView, bool isLeaf, bool printVTK=fals
   }
 }
 
+// Sends the rank and the center of each entity.  The receivers check the center and
+// sum up the ranks they got, which does not depend on the order of the messages.
+template <class Mapper>
+class RankSumDataHandle
+  : public Dune::CommDataHandleIF<RankSumDataHandle<Mapper>, double>
+{
+public:
+  typedef double DataType;
+
+  RankSumDataHandle (const Mapper& mapper, int codim, bool fixed, std::vector<double>& rankSum)
+    : mapper_(mapper), codim_(codim), fixed_(fixed), rankSum_(rankSum)
+  {}
+
+  bool contains (int dim, int codim) const
+  {
+    return codim == codim_;
+  }
+
+  // both say the same, but only a fixed size lets UGGrid use its own interfaces
+  bool fixedsize (int dim, int codim) const
+  {
+    return fixed_;
+  }
+
+  template <class Entity>
+  std::size_t size (const Entity& e) const
+  {
+    return 1 + Entity::Geometry::coorddimension;
+  }
+
+  template <class MessageBuffer, class Entity>
+  void gather (MessageBuffer& buff, const Entity& e) const
+  {
+    buff.write(Dune::MPIHelper::getCollectiveCommunication().rank());
+    const typename Entity::Geometry::GlobalCoordinate center = e.geometry().center();
+    for (int i=0; i<center.size(); i++)
+      buff.write(center[i]);
+  }
+
+  template <class MessageBuffer, class Entity>
+  void scatter (MessageBuffer& buff, const Entity& e, std::size_t n)
+  {
+    double rank;
+    buff.read(rank);
+    rankSum_[mapper_.map(e)] += rank;
+    const typename Entity::Geometry::GlobalCoordinate center = e.geometry().center();
+    for (int i=0; i<center.size(); i++)
+    {
+      double x;
+      buff.read(x);
+      if (std::abs(x - center[i]) > 1e-10)
+        DUNE_THROW(Dune::GridError, "Received the data of the entity at " << x << " for the one at " << center[i]);
+    }
+  }
+
+private:
+  const Mapper& mapper_;
+  int codim_;
+  bool fixed_;
+  std::vector<double>& rankSum_;
+};
+
+// The precomputed interfaces for fixed-size data have to deliver the same as the DDD interfaces
+template <class GridView, int commCodim>
+void checkFixedSizeCommunication(const GridView& gridView, Dune::InterfaceType iftype, Dune::CommunicationDirection dir)
+{
+  typedef Dune::MultipleCodimMultipleGeomTypeMapper<GridView, LayoutWrapper<commCodim>::template Layout> Mapper;
+  const Mapper mapper(gridView);
+
+  std::vector<double> fixedSum(mapper.size(), 0.0), variableSum(mapper.size(), 0.0);
+  RankSumDataHandle<Mapper> fixedHandle(mapper, commCodim, true, fixedSum);
+  RankSumDataHandle<Mapper> variableHandle(mapper, commCodim, false, variableSum);
+
+  // twice, the second time with the cached interface
+  for (int i=0; i<2; i++)
+  {
+    std::fill(fixedSum.begin(), fixedSum.end(), 0.0);
+    gridView.communicate(fixedHandle, iftype, dir);
+  }
+  gridView.communicate(variableHandle, iftype, dir);
+
+  for (std::size_t i=0; i<fixedSum.size(); i++)
+    if (fixedSum[i] != variableSum[i])
+      DUNE_THROW(Dune::GridError, "Process " << gridView.comm().rank() << " got the ranks " << fixedSum[i]
+                                             << " for codim " << commCodim << " entity " << i
+                                             << " over its own interface, but " << variableSum[i] << " from DDD");
+}
+
 //! edge and face communication
 template <class GridView, int commCodim>
 class EdgeAndFaceCommunication
@@ -499,6 +592,131 @@ public:
   }
 };
 
+// weight of an element for the graph partitioner: refined elements count more
+struct LevelWeight
+{
+  template <class Element>
+  double operator() (const Element& element) const
+  {
+    return element.level() + 1;
+  }
+};
+
+// weight of an element for the diffusion: the elements of the first process count more
+struct RankWeight
+{
+  explicit RankWeight (int rank) : rank_(rank) {}
+
+  template <class Element>
+  double operator() (const Element& element) const
+  {
+    return (rank_ == 0) ? 4 : 1;
+  }
+
+private:
+  int rank_;
+};
+
+// Rebalance the leaf elements by diffusion, check the plan and commit it
+template <class GridType>
+void checkDiffusion(GridType& grid)
+{
+  typedef typename GridType::LeafGridView GridView;
+  typedef typename GridView::template Codim<0>::template Partition<Dune::Interior_Partition>::Iterator Iterator;
+  typedef typename GridView::IntersectionIterator IntersectionIterator;
+
+  const GridView gridView = grid.leafView();
+  const int rank = grid.comm().rank();
+  const int size = grid.comm().size();
+  const RankWeight weight(rank);
+
+  std::vector<int> targetProcessors;
+  Dune::diffuseDualGraph(gridView, weight, targetProcessors);
+  const Dune::LoadBalanceStatistics statistics = Dune::loadBalanceStatistics(gridView, weight, targetProcessors);
+
+  if (statistics.predictedImbalance > statistics.imbalance + 1e-12)
+    DUNE_THROW(Dune::GridError, "Diffusion raises the imbalance from " << statistics.imbalance
+                                << " to " << statistics.predictedImbalance);
+  if (size > 1 && statistics.migratedElements == 0)
+    DUNE_THROW(Dune::GridError, "Diffusion does not move anything at imbalance " << statistics.imbalance);
+
+  // elements may only be handed to a process they share a face with
+  const Dune::MultipleCodimMultipleGeomTypeMapper<GridView, Dune::MCMGElementLayout> mapper(gridView);
+  std::vector<int> owner;
+  Dune::elementOwners(gridView, owner);
+
+  std::vector<int> expected(size, 0);
+  const Iterator end = gridView.template end<0,Dune::Interior_Partition>();
+  for (Iterator it = gridView.template begin<0,Dune::Interior_Partition>(); it != end; ++it)
+  {
+    const int target = targetProcessors[mapper.map(*it)];
+    expected[target]++;
+    if (target == rank)
+      continue;
+
+    bool boundary = false;
+    const IntersectionIterator iend = gridView.iend(*it);
+    for (IntersectionIterator iit = gridView.ibegin(*it); iit != iend; ++iit)
+      if (iit->neighbor() && owner[mapper.map(*iit->outside())] == target)
+        boundary = true;
+    if (!boundary)
+      DUNE_THROW(Dune::GridError, "Process " << rank << " sends an element to " << target
+                                             << " which is not at the boundary to that process");
+  }
+  grid.comm().sum(&expected[0], size);
+
+  if (rank == 0)
+    std::cout << "Diffusion lowers the imbalance from " << statistics.imbalance
+              << " to " << statistics.predictedImbalance << " moving "
+              << statistics.migratedElements << " elements.\n";
+
+  // the grid has to follow the plan
+  grid.loadBalance(targetProcessors, 0);
+  const GridView newGridView = grid.leafView();
+  int interior = 0;
+  const Iterator newEnd = newGridView.template end<0,Dune::Interior_Partition>();
+  for (Iterator it = newGridView.template begin<0,Dune::Interior_Partition>(); it != newEnd; ++it)
+    interior++;
+  if (interior != expected[rank])
+    DUNE_THROW(Dune::GridError, "Process " << rank << " has " << interior
+                                           << " elements after the diffusion instead of " << expected[rank]);
+}
+
+// the centers of the interior leaf elements of this process
+template <class GridType>
+std::set<std::vector<double> > interiorLeafCenters(const GridType& grid)
+{
+  typedef typename GridType::template Codim<0>::template Partition<Dune::Interior_Partition>::LeafIterator Iterator;
+  std::set<std::vector<double> > centers;
+  const Iterator endIt = grid.template leafend<0,Dune::Interior_Partition>();
+  for (Iterator it = grid.template leafbegin<0,Dune::Interior_Partition>(); it != endIt; ++it)
+  {
+    const typename GridType::template Codim<0>::Geometry::GlobalCoordinate center = it->geometry().center();
+    centers.insert(std::vector<double>(center.begin(), center.end()));
+  }
+  return centers;
+}
+
+// Back up a distributed grid, restore it, and check that each process gets its leaf elements back
+template <class GridType>
+void checkBackupRestore(Dune::shared_ptr<GridType>& grid)
+{
+  const std::set<std::vector<double> > centers = interiorLeafCenters(*grid);
+
+  std::stringstream stream;
+  Dune::BackupRestoreFacility<GridType>::backup(*grid, stream);
+
+  // there may be only one grid of each dimension at a time in parallel
+  grid.reset();
+  grid.reset(Dune::BackupRestoreFacility<GridType>::restore(stream));
+
+  if (interiorLeafCenters(*grid) != centers)
+    DUNE_THROW(Dune::GridError, "Process " << grid->comm().rank()
+                                           << " did not get its leaf elements back from the backup");
+  std::cout << "Process " << grid->comm().rank() + 1
+            << " got its " << centers.size() << " leaf elements back from the backup.\n";
+}
+
 template <int dim>
 void testParallelUG(bool localRefinement)
 {
@@ -648,6 +866,43 @@ void testParallelUG(bool localRefinement)
   if (dim == 3)
     EdgeAndFaceCommunication<typename GridType::LeafGridView, 1>::test(grid->leafView());
 
+  ////////////////////////////////////////////////////
+  //  Repartition the refined grid by its dual graph
+  ////////////////////////////////////////////////////
+
+  grid->loadBalance(Dune::GraphPartitioner(), LevelWeight());
+
+  std::cout << "Process " << grid->comm().rank() + 1
+            << " has " << grid->leafView().size(0)
+            << " leaf elements after graph partitioning.\n";
+  assert(grid->leafView().size(0) > 0);
+
+  checkIntersections(grid->leafView());
+  testCommunication<typename GridType::LeafGridView, 0>(grid->leafView(), true);
+  testCommunication<typename GridType::LeafGridView, dim>(grid->leafView(), true);
+
+  // compare the communication of fixed-size data with the DDD interfaces
+  checkFixedSizeCommunication<LeafGV, 0>(grid->leafView(), Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+  checkFixedSizeCommunication<LeafGV, 0>(grid->leafView(), Dune::InteriorBorder_All_Interface, Dune::BackwardCommunication);
+  checkFixedSizeCommunication<LeafGV, dim>(grid->leafView(), Dune::InteriorBorder_InteriorBorder_Interface, Dune::ForwardCommunication);
+  checkFixedSizeCommunication<LeafGV, dim>(grid->leafView(), Dune::All_All_Interface, Dune::ForwardCommunication);
+  checkFixedSizeCommunication<LevelGV, 0>(grid->levelView(0), Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+
+  ////////////////////////////////////////////////////
+  //  Rebalance the grid by diffusion
+  ////////////////////////////////////////////////////
+
+  checkDiffusion(*grid);
+  checkIntersections(grid->leafView());
+  testCommunication<typename GridType::LeafGridView, 0>(grid->leafView(), true);
+
+  ////////////////////////////////////////////////////
+  //  Back up the leaf partitioned grid and restore it
+  ////////////////////////////////////////////////////
+
+  checkBackupRestore(grid);
+  checkIntersections(grid->leafView());
+  testCommunication<typename GridType::LeafGridView, 0>(grid->leafView(), true);
 }
 
 int main (int argc , char **argv) try
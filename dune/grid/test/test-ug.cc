@@ -4,7 +4,14 @@
 
 #include <config.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 /*
 
@@ -13,6 +20,7 @@
  */
 
 #include <dune/grid/uggrid.hh>
+#include <dune/grid/common/mcmgmapper.hh>
 #include <doc/grids/gridfactory/hybridtestgrids.hh>
 
 #include "gridcheck.cc"
@@ -150,6 +158,335 @@ void markOne ( GridType & grid , int num , int ref )
   grid.postAdapt();
 }
 
+/** \brief Check that the incremental leaf index update keeps the indices of unchanged
+    elements and vertices, and that UGGrid::leafIndexMap() maps the old
+    indices of all surviving entities to their new ones. */
+template <class GridType>
+void checkIncrementalLeafIndexUpdate(GridType& grid)
+{
+  const int dim = GridType::dimension;
+  typedef typename GridType::LeafGridView GridView;
+  typedef typename GridType::Traits::LocalIdSet::IdType IdType;
+  typedef typename GridView::template Codim<0>::Iterator ElementIterator;
+  typedef typename GridView::template Codim<dim>::Iterator VertexIterator;
+
+  grid.setIncrementalLeafIndexUpdate(true);
+
+  // refine one element and coarsen it again, the first step follows a full numbering
+  for (int step=0; step<2; step++)
+  {
+    const GridView gridView = grid.leafView();
+    const typename GridType::Traits::LocalIdSet& idSet = grid.localIdSet();
+
+    std::map<IdType, std::pair<GeometryType,int> > oldIndices;
+    std::map<GeometryType,int> oldSizes;
+    for (ElementIterator eIt = gridView.template begin<0>(); eIt != gridView.template end<0>(); ++eIt)
+    {
+      oldIndices[idSet.id(*eIt)] = std::make_pair(eIt->type(), int(gridView.indexSet().index(*eIt)));
+      oldSizes[eIt->type()] = gridView.size(eIt->type());
+    }
+    for (VertexIterator vIt = gridView.template begin<dim>(); vIt != gridView.template end<dim>(); ++vIt)
+      oldIndices[idSet.id(*vIt)] = std::make_pair(vIt->type(), int(gridView.indexSet().index(*vIt)));
+    oldSizes[GeometryType(0)] = gridView.size(dim);
+
+    ElementIterator eIt = gridView.template begin<0>();
+    if (step==0)
+      grid.mark(1, *eIt);
+    else
+      for (; eIt != gridView.template end<0>(); ++eIt)
+        if (eIt->level() > 0)
+          grid.mark(-1, *eIt);
+
+    grid.preAdapt();
+    grid.adapt();
+    grid.postAdapt();
+
+    // entities which stay in the leaf grid keep their index, unless they close a hole
+    std::map<GeometryType,int> moved;
+    const GridView newGridView = grid.leafView();
+    for (ElementIterator eIt = newGridView.template begin<0>(); eIt != newGridView.template end<0>(); ++eIt)
+    {
+      typename std::map<IdType, std::pair<GeometryType,int> >::const_iterator old = oldIndices.find(idSet.id(*eIt));
+      if (old != oldIndices.end() && old->second.second != int(newGridView.indexSet().index(*eIt)))
+        moved[eIt->type()]++;
+      if (old != oldIndices.end()
+          && (int(grid.leafIndexMap(eIt->type()).size()) <= old->second.second
+              || grid.leafIndexMap(eIt->type())[old->second.second] != int(newGridView.indexSet().index(*eIt))))
+        DUNE_THROW(GridError, "leafIndexMap() does not map the old element index " << old->second.second
+                                                                               << " to the new one " << newGridView.indexSet().index(*eIt));
+    }
+    for (VertexIterator vIt = newGridView.template begin<dim>(); vIt != newGridView.template end<dim>(); ++vIt)
+    {
+      typename std::map<IdType, std::pair<GeometryType,int> >::const_iterator old = oldIndices.find(idSet.id(*vIt));
+      if (old != oldIndices.end() && old->second.second != int(newGridView.indexSet().index(*vIt)))
+        moved[vIt->type()]++;
+      if (old != oldIndices.end()
+          && (int(grid.leafIndexMap(vIt->type()).size()) <= old->second.second
+              || grid.leafIndexMap(vIt->type())[old->second.second] != int(newGridView.indexSet().index(*vIt))))
+        DUNE_THROW(GridError, "leafIndexMap() does not map the old vertex index " << old->second.second
+                                                                              << " to the new one " << newGridView.indexSet().index(*vIt));
+    }
+    for (typename std::map<GeometryType,int>::const_iterator m = moved.begin(); m != moved.end(); ++m)
+    {
+      const int holes = std::max(oldSizes[m->first] - newGridView.size(m->first), 0);
+      if (m->second > holes)
+        DUNE_THROW(GridError, m->second << " unchanged entities of type " << m->first
+                                        << " got a new leaf index, but only " << holes << " holes had to be closed");
+    }
+
+    gridcheck(grid);
+  }
+
+  grid.setIncrementalLeafIndexUpdate(false);
+}
+
+/** \brief What a leaf element geometry computes, at the reference center and halfway from there to each corner */
+template <int dim>
+struct GeometryData
+{
+  std::vector<FieldVector<double,dim> > corners, global, local;
+  std::vector<double> integrationElements;
+  std::vector<FieldMatrix<double,dim,dim> > jacobianTransposed, jacobianInverseTransposed;
+  double volume;
+  FieldVector<double,dim> center;
+};
+
+/** \brief Collect the geometry data of all leaf elements, indexed by an element mapper */
+template <class GridType>
+std::vector<GeometryData<GridType::dimension> > leafGeometryData(const GridType& grid)
+{
+  const int dim = GridType::dimension;
+  typedef typename GridType::LeafGridView GridView;
+  typedef typename GridView::template Codim<0>::Iterator ElementIterator;
+  typedef typename GridType::template Codim<0>::Geometry Geometry;
+
+  const GridView gridView = grid.leafView();
+
+  // The leaf indices of different element types overlap on hybrid grids, hence the mapper
+  const MultipleCodimMultipleGeomTypeMapper<GridView, MCMGElementLayout> mapper(gridView);
+
+  std::vector<GeometryData<dim> > data(mapper.size());
+  for (ElementIterator eIt = gridView.template begin<0>(); eIt != gridView.template end<0>(); ++eIt) {
+    GeometryData<dim>& d = data[mapper.map(*eIt)];
+    const Geometry geometry = eIt->geometry();
+    const ReferenceElement<double,dim>& refElement = ReferenceElements<double,dim>::general(eIt->type());
+
+    d.volume = geometry.volume();
+    d.center = geometry.center();
+    for (int i=0; i<=geometry.corners(); i++) {
+      // away from the corners, where the pyramid mapping is singular
+      FieldVector<double,dim> x = refElement.position(0,0);
+      if (i < geometry.corners()) {
+        x += refElement.position(i,dim);
+        x *= 0.5;
+        d.corners.push_back(geometry.corner(i));
+      }
+      d.global.push_back(geometry.global(x));
+      d.local.push_back(geometry.local(geometry.global(x)));
+      d.integrationElements.push_back(geometry.integrationElement(x));
+      d.jacobianTransposed.push_back(geometry.jacobianTransposed(x));
+      d.jacobianInverseTransposed.push_back(geometry.jacobianInverseTransposed(x));
+    }
+  }
+  return data;
+}
+
+inline double geometryDifference(double a, double b)
+{
+  return std::abs(a - b) / (1.0 + std::abs(b));
+}
+
+template <int n>
+double geometryDifference(const FieldVector<double,n>& a, const FieldVector<double,n>& b)
+{
+  FieldVector<double,n> d = a;
+  d -= b;
+  return d.two_norm() / (1.0 + b.two_norm());
+}
+
+template <int n>
+double geometryDifference(const FieldMatrix<double,n,n>& a, const FieldMatrix<double,n,n>& b)
+{
+  FieldMatrix<double,n,n> d = a;
+  d -= b;
+  return d.frobenius_norm() / (1.0 + b.frobenius_norm());
+}
+
+template <class T>
+void compareGeometryData(const char* what, const std::string& when, std::size_t element,
+                         const std::vector<T>& cached, const std::vector<T>& computed)
+{
+  if (cached.size() != computed.size())
+    DUNE_THROW(GridError, "Cached geometry of element " << element << " has " << cached.size()
+                          << " values of " << what << " instead of " << computed.size() << " " << when);
+  for (std::size_t i=0; i<cached.size(); i++)
+    if (geometryDifference(cached[i], computed[i]) > 1e-10)
+      DUNE_THROW(GridError, "Cached " << what << " " << cached[i] << " of element " << element
+                                      << " differs from the computed " << computed[i] << " " << when);
+}
+
+/** \brief Compare the geometries of the cache against the ones computed from the UG data
+
+    The geometry cache has to be switched on.
+ */
+template <class GridType>
+void compareCachedGeometries(GridType& grid, const std::string& when)
+{
+  const int dim = GridType::dimension;
+
+  // Query the cache as it is, then compute without it.  Switching the cache on
+  // again invalidates it, so it is filled right away: a later change of the grid
+  // has to invalidate it by itself.
+  const std::vector<GeometryData<dim> > cached = leafGeometryData(grid);
+  grid.setGeometryCaching(false);
+  const std::vector<GeometryData<dim> > computed = leafGeometryData(grid);
+  grid.setGeometryCaching(true);
+  leafGeometryData(grid);
+
+  if (cached.size() != computed.size())
+    DUNE_THROW(GridError, "The cache has " << cached.size() << " leaf elements instead of " << computed.size() << " " << when);
+  for (std::size_t i=0; i<cached.size(); i++) {
+    compareGeometryData("corner", when, i, cached[i].corners, computed[i].corners);
+    compareGeometryData("global()", when, i, cached[i].global, computed[i].global);
+    compareGeometryData("local()", when, i, cached[i].local, computed[i].local);
+    compareGeometryData("integrationElement()", when, i, cached[i].integrationElements, computed[i].integrationElements);
+    compareGeometryData("jacobianTransposed()", when, i, cached[i].jacobianTransposed, computed[i].jacobianTransposed);
+    compareGeometryData("jacobianInverseTransposed()", when, i, cached[i].jacobianInverseTransposed, computed[i].jacobianInverseTransposed);
+    compareGeometryData("volume()", when, i, std::vector<double>(1, cached[i].volume), std::vector<double>(1, computed[i].volume));
+    compareGeometryData("center()", when, i, std::vector<FieldVector<double,dim> >(1, cached[i].center),
+                        std::vector<FieldVector<double,dim> >(1, computed[i].center));
+  }
+}
+
+/** \brief Scale all vertex positions of a grid by the given factor */
+template <class GridType>
+void scaleGrid(GridType& grid, double factor)
+{
+  const int dim = GridType::dimension;
+  typedef typename GridType::LeafGridView::template Codim<dim>::Iterator VertexIterator;
+
+  const typename GridType::LeafGridView gridView = grid.leafView();
+  for (VertexIterator vIt = gridView.template begin<dim>(); vIt != gridView.template end<dim>(); ++vIt) {
+    FieldVector<double,dim> position = vIt->geometry().corner(0);
+    position *= factor;
+    grid.setPosition(vIt, position);
+  }
+}
+
+/** \brief Check that the cached leaf element geometries agree with the ones computed from the UG data,
+    also after refinement and after moving the vertices */
+template <class GridType>
+void checkGeometryCaching(GridType& grid)
+{
+  typedef typename GridType::template Codim<0>::LeafIterator ElementIterator;
+
+  grid.setGeometryCaching(true);
+  compareCachedGeometries(grid, "on the initial grid");
+
+  // refine a few elements, so that the cache has to pick up new and vanished elements
+  int marked = 0;
+  for (ElementIterator eIt = grid.template leafbegin<0>(); eIt != grid.template leafend<0>() && marked < 3; ++eIt, ++marked)
+    grid.mark(1, *eIt);
+  grid.preAdapt();
+  grid.adapt();
+  grid.postAdapt();
+  compareCachedGeometries(grid, "after refinement");
+
+  // move the vertices, which changes every geometry but not the elements; a factor of two is exact
+  scaleGrid(grid, 2.0);
+  compareCachedGeometries(grid, "after moving the vertices");
+  scaleGrid(grid, 0.5);
+  compareCachedGeometries(grid, "after moving the vertices back");
+
+  gridcheck(grid);
+
+  grid.setGeometryCaching(false);
+}
+
+/** \brief Back up a grid into a stream, replace it by the restored grid, and check
+    that both have the same number of elements on each level. */
+template <class GridType>
+void checkBackupRestore(std::auto_ptr<GridType>& grid)
+{
+  std::vector<int> levelSizes;
+  for (int level=0; level<=grid->maxLevel(); level++)
+    levelSizes.push_back(grid->size(level, 0));
+  const int leafSize = grid->size(0);
+
+  std::stringstream stream;
+  BackupRestoreFacility<GridType>::backup(*grid, stream);
+
+  // there may be only one grid of each dimension at a time in parallel
+  grid.reset();
+  grid.reset(BackupRestoreFacility<GridType>::restore(stream));
+
+  if (grid->maxLevel()+1 != int(levelSizes.size()))
+    DUNE_THROW(GridError, "The restored grid has " << grid->maxLevel()+1 << " levels instead of " << levelSizes.size());
+  for (int level=0; level<=grid->maxLevel(); level++)
+    if (grid->size(level, 0) != levelSizes[level])
+      DUNE_THROW(GridError, "The restored grid has " << grid->size(level, 0) << " elements on level " << level
+                                                     << " instead of " << levelSizes[level]);
+  if (grid->size(0) != leafSize)
+    DUNE_THROW(GridError, "The restored grid has " << grid->size(0) << " leaf elements instead of " << leafSize);
+
+  gridcheck(*grid);
+}
+
+/** \brief Build a structured grid of quadrilaterals and triangles with the bulk insertion
+    methods of the grid factory and check that the elements have the expected corners. */
+void checkBulkInsertion()
+{
+  const int n = 4;
+  std::vector<double> coordinates;
+  for (int j=0; j<=n; j++)
+    for (int i=0; i<=n; i++) {
+      coordinates.push_back(double(i)/n);
+      coordinates.push_back(double(j)/n);
+    }
+
+  // the lower half of the squares as quadrilaterals, the upper half split into triangles
+  std::vector<unsigned int> quadrilaterals, triangles;
+  for (int j=0; j<n; j++)
+    for (int i=0; i<n; i++) {
+      unsigned int v[4] = {unsigned(j*(n+1)+i), unsigned(j*(n+1)+i+1), unsigned((j+1)*(n+1)+i), unsigned((j+1)*(n+1)+i+1)};
+      if (j < n/2)
+        quadrilaterals.insert(quadrilaterals.end(), v, v+4);
+      else {
+        triangles.insert(triangles.end(), v, v+3);
+        triangles.insert(triangles.end(), v+1, v+4);
+      }
+    }
+
+  GeometryType quadrilateral, triangle;
+  quadrilateral.makeQuadrilateral();
+  triangle.makeTriangle();
+
+  Dune::GridFactory<Dune::UGGrid<2> > factory;
+  if (MPIHelper::getCollectiveCommunication().rank() == 0) {
+    factory.insertVertices(coordinates);
+    factory.insertElements(quadrilateral, quadrilaterals);
+    factory.insertElements(triangle, triangles);
+  }
+  std::auto_ptr<Dune::UGGrid<2> > grid(factory.createGrid());
+
+  typedef Dune::UGGrid<2>::Codim<0>::LevelIterator ElementIterator;
+  for (ElementIterator eIt = grid->lbegin<0>(0); eIt != grid->lend<0>(0); ++eIt) {
+    // the level 0 element indices are the insertion indices among the elements of the same type
+    const unsigned int index = grid->levelIndexSet(0).index(*eIt);
+    const bool isQuadrilateral = eIt->type().isQuadrilateral();
+    if (index >= (isQuadrilateral ? quadrilaterals.size()/4 : triangles.size()/3))
+      DUNE_THROW(GridError, "Element " << index << " of type " << eIt->type() << " has not been inserted");
+    const unsigned int* corners = isQuadrilateral ? &quadrilaterals[4*index] : &triangles[3*index];
+    for (int i=0; i<eIt->geometry().corners(); i++)
+      for (int k=0; k<2; k++)
+        if (std::abs(eIt->geometry().corner(i)[k] - coordinates[2*corners[i]+k]) > 1e-10)
+          DUNE_THROW(GridError, "Corner " << i << " of element " << index << " is at " << eIt->geometry().corner(i)
+                                          << " which is not the position of vertex " << corners[i]);
+  }
+
+  gridcheck(*grid);
+}
+
 void generalTests(bool greenClosure)
 {
   // /////////////////////////////////////////////////////////////////
@@ -230,6 +567,18 @@ void generalTests(bool greenClosure)
   checkIntersectionIterator(*grid2d);
   checkIntersectionIterator(*grid3d);
 
+  // check the incremental update of the leaf indices
+  checkIncrementalLeafIndexUpdate(*grid2d);
+  checkIncrementalLeafIndexUpdate(*grid3d);
+
+  // check the geometry cache
+  checkGeometryCaching(*grid2d);
+  checkGeometryCaching(*grid3d);
+
+  // check backup and restore
+  checkBackupRestore(grid2d);
+  checkBackupRestore(grid3d);
+
 }
 
 int main (int argc , char **argv) try
@@ -265,6 +614,11 @@ int main (int argc , char **argv) try
 #ifdef ModelP
   }
 #endif
+  // ////////////////////////////////////////////////////////////////////////
+  //   Test the bulk insertion of vertices and elements into the grid factory
+  // ////////////////////////////////////////////////////////////////////////
+  checkBulkInsertion();
+
   // ////////////////////////////////////////////////////////////////////////
   //   Check whether geometryInFather returns equal results with and
   //   without parametrized boundaries
@@ -4,7 +4,10 @@
 
 #include <config.h>
 
+#include <algorithm>
 #include <iostream>
+#include <cmath>
+#include <vector>
 
 #include <dune/grid/yaspgrid.hh>
 
@@ -17,6 +20,174 @@
 
 int rank;
 
+// communicates the centers of all entities of one codim and checks that
+// sender and receiver agree on the position of the entity
+template <class Grid>
+class CenterCheckDataHandle
+  : public Dune::CommDataHandleIF<CenterCheckDataHandle<Grid>, double>
+{
+public:
+  enum { dim = Grid::dimension };
+
+  CenterCheckDataHandle (int codim) : codim_(codim), errors_(0) {}
+
+  bool contains (int, int codim) const { return codim == codim_; }
+
+  bool fixedsize (int, int) const { return true; }
+
+  template<class Entity>
+  size_t size (const Entity&) const { return dim; }
+
+  template<class MessageBuffer, class Entity>
+  void gather (MessageBuffer& buff, const Entity& e) const
+  {
+    for (int k=0; k<dim; k++)
+      buff.write(e.geometry().center()[k]);
+  }
+
+  template<class MessageBuffer, class Entity>
+  void scatter (MessageBuffer& buff, const Entity& e, size_t n)
+  {
+    for (size_t k=0; k<n; k++)
+    {
+      double x;
+      buff.read(x);
+      if (std::abs(x-e.geometry().center()[k]) > 1e-8)
+        errors_++;
+    }
+  }
+
+  int errors () const { return errors_; }
+
+private:
+  int codim_;
+  int errors_;
+};
+
+// check the split-phase communication of YaspGrid
+template <class Grid>
+void checkSplitPhaseCommunication (const Grid& grid)
+{
+  enum { dim = Grid::dimension };
+  typedef CenterCheckDataHandle<Grid> DataHandle;
+  DataHandle cells(0);
+  DataHandle vertices(dim);
+  {
+    Dune::YaspCommunication<const Grid, DataHandle> cellcomm;
+    Dune::YaspCommunication<const Grid, DataHandle> vertexcomm;
+    grid.communicateBegin(cellcomm,cells,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+    grid.communicateBegin(vertexcomm,vertices,Dune::All_All_Interface,Dune::ForwardCommunication);
+    while (!cellcomm.ready()) ;
+    cellcomm.finish();
+    // vertexcomm is finished by its destructor
+  }
+  {
+    // reuse a persistent handle for repeated exchanges of the same interface
+    Dune::YaspCommunication<const Grid, DataHandle> vertexcomm(true);
+    for (int i=0; i<3; i++)
+    {
+      grid.communicateBegin(vertexcomm,vertices,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+      grid.communicateFinish(vertexcomm);
+    }
+  }
+  if (cells.errors() > 0 || vertices.errors() > 0)
+    DUNE_THROW(Dune::GridError, "split-phase communication delivered wrong data");
+}
+
+// check the communication of data stored in vectors indexed by the leaf index set
+template <class Grid>
+void checkVectorCommunication (const Grid& grid)
+{
+  enum { dim = Grid::dimension };
+  typedef typename Grid::LeafGridView GridView;
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+  const GridView gv = grid.leafView();
+
+  // store cell centers on interior cells only
+  std::vector<double> centers(dim*gv.size(0), -1.0);
+  for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    if (it->partitionType() == Dune::InteriorEntity)
+      for (int k=0; k<dim; k++)
+        centers[dim*gv.indexSet().index(*it)+k] = it->geometry().center()[k];
+
+  grid.communicateVector(centers,0,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+
+  // now all cells must know their center
+  for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    for (int k=0; k<dim; k++)
+      if (std::abs(centers[dim*gv.indexSet().index(*it)+k] - it->geometry().center()[k]) > 1e-8)
+        DUNE_THROW(Dune::GridError, "vector communication delivered wrong data");
+}
+
+// check that the tiles of each level cover the interior cells exactly once
+template <class Grid>
+void checkTiles (const Grid& grid, int maxcells)
+{
+  typedef typename Grid::LevelGridView GridView;
+  typedef typename Grid::Tile Tile;
+  for (int level=0; level<=grid.maxLevel(); level++)
+  {
+    const GridView gv = grid.levelView(level);
+    std::vector<int> visits(gv.size(0), 0);
+    const std::vector<Tile> tiles = grid.tiles(level,maxcells);
+    for (size_t t=0; t<tiles.size(); t++)
+    {
+      int cells = 0;
+      for (typename Tile::Iterator it = tiles[t].begin(); it != tiles[t].end(); ++it, ++cells)
+      {
+        if (it->partitionType() != Dune::InteriorEntity)
+          DUNE_THROW(Dune::GridError, "tile contains a non-interior cell");
+        visits[gv.indexSet().index(*it)]++;
+      }
+      if (cells != tiles[t].size() || cells > maxcells)
+        DUNE_THROW(Dune::GridError, "tile has wrong number of cells");
+    }
+    typedef typename GridView::template Codim<0>::template Partition<Dune::Interior_Partition>::Iterator Iterator;
+    for (Iterator it = gv.template begin<0,Dune::Interior_Partition>(); it != gv.template end<0,Dune::Interior_Partition>(); ++it)
+      if (visits[gv.indexSet().index(*it)] != 1)
+        DUNE_THROW(Dune::GridError, "tiles do not cover the interior cells");
+  }
+}
+
+// check that the blocked traversal visits all cells exactly once
+template <class Grid>
+void checkBlockedTraversal (Grid& grid, int blocksize)
+{
+  enum { dim = Grid::dimension };
+  typedef typename Grid::LeafGridView GridView;
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+
+  grid.cellTraversalBlock(Dune::FieldVector<int,dim>(blocksize));
+  const GridView gv = grid.leafView();
+  std::vector<int> visits(gv.size(0), 0);
+  for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    visits[gv.indexSet().index(*it)]++;
+  grid.cellTraversalLexicographic();
+
+  for (size_t i=0; i<visits.size(); i++)
+    if (visits[i] != 1)
+      DUNE_THROW(Dune::GridError, "blocked traversal visits cell " << i << " " << visits[i] << " times");
+}
+
+// check the direct lookup of the neighbor index against the outside entity
+template <class Grid>
+void checkOutsideIndex (const Grid& grid)
+{
+  typedef typename Grid::LeafGridView GridView;
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+  typedef typename GridView::IntersectionIterator IntersectionIterator;
+  const GridView gv = grid.leafView();
+  for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    for (IntersectionIterator is = gv.ibegin(*it); is != gv.iend(*it); ++is)
+    {
+      const int index = grid.outsideIndex(*is);
+      if (is->neighbor() ? index != gv.indexSet().index(*is->outside()) : index != -1)
+        DUNE_THROW(Dune::GridError, "outsideIndex does not match the index of the neighbor");
+      if (grid.periodic(*is) ? !is->boundary() : (is->boundary() && is->neighbor()))
+        DUNE_THROW(Dune::GridError, "wrong periodic flag of intersection");
+    }
+}
+
 template <int dim>
 void check_yasp(bool p0=false) {
   typedef Dune::FieldVector<double,dim> fTupel;
@@ -49,6 +220,13 @@ void check_yasp(bool p0=false) {
   checkCommunication(grid,-1,Dune::dvverb);
   for(int l=0; l<=grid.maxLevel(); ++l)
     checkCommunication(grid,l,Dune::dvverb);
+  checkSplitPhaseCommunication(grid);
+  checkVectorCommunication(grid);
+  checkTiles(grid,5);
+  checkTiles(grid,40);
+  checkBlockedTraversal(grid,2);
+  checkBlockedTraversal(grid,3);
+  checkOutsideIndex(grid);
 
   // check geometry lifetime
   checkGeometryLifetime( grid.leafView() );
@@ -61,6 +239,174 @@ void check_yasp(bool p0=false) {
   checkPartitionType( grid.leafView() );
 }
 
+// check a YaspGrid partitioned with non-uniform cell cost
+template <int dim>
+void check_yasp_weighted() {
+  typedef Dune::YaspGrid<dim> Grid;
+  typedef typename Grid::LevelGridView GridView;
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+
+  std::cout << std::endl << "YaspGrid<" << dim << "> with weighted load balancing";
+  std::cout << std::endl << std::endl;
+
+  Dune::FieldVector<double,dim> Len(1.0);
+  Dune::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 4);
+  s[0] = 12;
+
+  // the cells of the first third in direction 0 are five times as expensive
+  Dune::array<std::vector<double>,dim> weights;
+  for (int k=0; k<s[0]; k++)
+    weights[0].push_back(k < s[0]/3 ? 5.0 : 1.0);
+  Dune::YLoadBalanceWeighted<dim> lb(weights);
+
+#if HAVE_MPI
+  Grid grid(MPI_COMM_WORLD,Len,s,std::bitset<dim>(0),1,&lb);
+#else
+  Grid grid(Len,s,std::bitset<dim>(0),1,&lb);
+#endif
+
+  gridcheck(grid);
+  checkCommunication(grid,0,Dune::dvverb);
+
+  // the interior cells still cover the whole coarse grid
+  const GridView gv = grid.levelView(0);
+  int cells = 0;
+  double cost = 0.0;
+  for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    if (it->partitionType() == Dune::InteriorEntity)
+    {
+      cells++;
+      cost += weights[0][int(it->geometry().center()[0]*s[0])];
+    }
+  int total = 1;
+  for (int i=0; i<dim; i++)
+    total *= s[i];
+  if (grid.comm().sum(cells) != total)
+    DUNE_THROW(Dune::GridError, "weighted partition lost cells");
+
+  // processes with more expensive cells get fewer of them
+  const int P = grid.comm().size();
+  std::vector<int> allCells(P);
+  std::vector<double> allCosts(P);
+  grid.comm().allgather(&cells, 1, &allCells[0]);
+  grid.comm().allgather(&cost, 1, &allCosts[0]);
+  for (int p=0; p<P; p++)
+    for (int q=0; q<P; q++)
+      if (allCosts[p]*allCells[q] > allCosts[q]*allCells[p] && allCells[p] > allCells[q])
+        DUNE_THROW(Dune::GridError, "process " << p << " has " << allCells[p] << " cells of cost "
+                                               << allCosts[p] << ", but process " << q << " only "
+                                               << allCells[q] << " cheaper ones");
+
+  // the cuts are at equal accumulated weight: the expensive third goes into the first two
+  // of three slabs, and no slab is off the mean by more than one cell layer
+  std::vector<int> offsets;
+  lb.partition(0, s[0], 3, offsets);
+  const int expected[] = { 0, 2, 4, 12 };
+  for (int j=0; j<=3; j++)
+    if (offsets[j] != expected[j])
+      DUNE_THROW(Dune::GridError, "weighted cut " << j << " at cell " << offsets[j]
+                                                  << " instead of " << expected[j]);
+  for (int parts=1; parts<=s[0]; parts++)
+  {
+    lb.partition(0, s[0], parts, offsets);
+    double sum = 0.0;
+    for (int k=0; k<s[0]; k++)
+      sum += weights[0][k];
+    for (int j=0; j<parts; j++)
+    {
+      double slab = 0.0;
+      for (int k=offsets[j]; k<offsets[j+1]; k++)
+        slab += weights[0][k];
+      if (offsets[j+1] <= offsets[j] || (parts < s[0]/2 && std::abs(slab - sum/parts) > 5.0))
+        DUNE_THROW(Dune::GridError, "slab " << j << " of " << parts << " has weight " << slab
+                                            << " instead of about " << sum/parts);
+    }
+  }
+
+  // on nodes with 2^dim processes each node gets a 2x...x2 block of a 4x...x4 torus,
+  // which has more neighbours within the node than the lexicographic rows
+  typename Dune::YLoadBalanceWeighted<dim>::iTupel dims(4);
+  const int c = 1<<dim;
+  std::vector<int> node(Dune::Power<dim>::eval(4));
+  for (std::size_t r=0; r<node.size(); r++)
+    node[r] = r/c;
+  std::vector<int> rankmap;
+  lb.rankmap(dims, node, rankmap);
+  std::vector<int> lower(node.size()/c*dim, 4), upper(node.size()/c*dim, -1);
+  int pairs = 0;
+  for (std::size_t k=0; k<rankmap.size(); k++)
+  {
+    const int n = node[rankmap[k]];
+    int stride = 1;
+    for (int i=0; i<dim; i++, stride*=4)
+    {
+      const int x = (k/stride)%4;
+      lower[n*dim+i] = std::min(lower[n*dim+i], x);
+      upper[n*dim+i] = std::max(upper[n*dim+i], x);
+      if (x < 3 && node[rankmap[k+stride]] == n)
+        pairs++;
+    }
+  }
+  for (std::size_t n=0; n<node.size()/c; n++)
+    for (int i=0; i<dim; i++)
+      if (upper[n*dim+i] - lower[n*dim+i] != 1)
+        DUNE_THROW(Dune::GridError, "the processes of node " << n << " do not form a block");
+  if (pairs != int(node.size()/c)*dim*(c/2))
+    DUNE_THROW(Dune::GridError, "only " << pairs << " neighbouring processes share a node");
+}
+
+// check a YaspGrid with graded tensor-product coordinates
+template <int dim>
+void check_yasp_tensorproduct() {
+  typedef Dune::YaspGrid<dim, Dune::TensorProductCoordinates<double,dim> > Grid;
+  typedef typename Grid::LeafGridView GridView;
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+
+  std::cout << std::endl << "YaspGrid<" << dim << "> with tensor-product coordinates";
+  std::cout << std::endl << std::endl;
+
+  // coordinates graded towards the lower boundary, the domain is [-1,1]^dim
+  Dune::array<std::vector<double>,dim> coords;
+  for (int i=0; i<dim; i++)
+  {
+    const int n = (i==0) ? 6 : 3;
+    for (int k=0; k<=n; k++)
+      coords[i].push_back(-1.0 + 2.0*std::pow(double(k)/n, 2));
+  }
+  std::bitset<dim> p(0);
+  int overlap = 1;
+
+#if HAVE_MPI
+  Grid grid(MPI_COMM_WORLD,coords,p,overlap);
+#else
+  Grid grid(coords,p,overlap);
+#endif
+
+  gridcheck(grid);
+
+  grid.globalRefine(1);
+
+  gridcheck(grid);
+
+  // the interior cells cover the domain
+  const GridView gv = grid.leafView();
+  double volume = 0.0;
+  for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    if (it->partitionType() == Dune::InteriorEntity)
+      volume += it->geometry().volume();
+  volume = grid.comm().sum(volume);
+  if (std::abs(volume - std::pow(2.0,dim)) > 1e-8)
+    DUNE_THROW(Dune::GridError, "tensor-product grid has wrong volume " << volume);
+
+  checkCommunication(grid,-1,Dune::dvverb);
+  checkSplitPhaseCommunication(grid);
+  checkVectorCommunication(grid);
+  checkGeometryInFather(grid);
+  checkIntersectionIterator(grid);
+  checkPartitionType( grid.leafView() );
+}
+
 int main (int argc , char **argv) {
   try {
 #if HAVE_MPI
@@ -79,6 +425,11 @@ int main (int argc , char **argv) {
     //check_yasp<3>(true);
     //check_yasp<4>();
 
+    check_yasp_weighted<2>();
+
+    check_yasp_tensorproduct<2>();
+    check_yasp_tensorproduct<3>();
+
   } catch (Dune::Exception &e) {
     std::cerr << e << std::endl;
     return 1;
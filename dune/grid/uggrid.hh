@@ -8,15 +8,20 @@
  * \brief The UGGrid class
  */
 
+#include <map>
+
 #include <dune/common/classname.hh>
 #include <dune/common/parallel/collectivecommunication.hh>
 #include <dune/common/exceptions.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/shared_ptr.hh>
 #include <dune/common/static_assert.hh>
+#include <dune/common/typetraits.hh>
 
 #include <dune/grid/common/boundarysegment.hh>
 #include <dune/grid/common/capabilities.hh>
 #include <dune/grid/common/grid.hh>
+#include <dune/grid/utility/graphpartitioner.hh>
 
 #if HAVE_UG
 
@@ -98,11 +103,13 @@
 #include "uggrid/uggridindexsets.hh"
 #ifdef ModelP
 #include "uggrid/ugmessagebuffer.hh"
+#include "uggrid/ugcomminterface.hh"
 #include "uggrid/uglbgatherscatter.hh"
 #endif
 
 // Not needed here, but included for user convenience
 #include "uggrid/uggridfactory.hh"
+#include "uggrid/ugbackuprestore.hh"
 
 #ifdef ModelP
 template <class DataHandle, int GridDim, int codim>
@@ -221,9 +228,12 @@ namespace Dune {
     friend class UGGridIdSet<const UGGrid<dim> >;
 
     friend class GridFactory<UGGrid<dim> >;
+    friend struct BackupRestoreFacility<UGGrid<dim> >;
 
 #ifdef ModelP
     friend class UGLBGatherScatter;
+    template <int dim_, int codim_>
+    friend class UGCommInterface;
 #endif
 
     template <int codim_, PartitionIteratorType PiType_, class GridImp_>
@@ -546,6 +556,69 @@ namespace Dune {
      */
     bool loadBalance(int strategy, int minlevel, int depth, int maxlevel, int minelement);
 
+    /** \brief Send the leaf elements to given processors
+
+       Each interior leaf element is sent, together with its ancestors from level
+       fromLevel on, to the processor targetProcessors[mapper.map(element)], where
+       mapper is a LeafMultipleCodimMultipleGeomTypeMapper with MCMGElementLayout.
+       The leaf index set cannot be used directly, because it numbers the elements
+       of each geometry type separately.
+
+       \return true if the grid has changed
+     */
+    bool loadBalance(const std::vector<int>& targetProcessors, int fromLevel);
+
+    /** \brief Send the leaf elements to given processors and transfer data with them
+
+       \tparam DataHandle works like the data handle for the communicate
+       methods.
+     */
+    template<class DataHandle>
+    bool loadBalance (const std::vector<int>& targetProcessors, int fromLevel, DataHandle& dataHandle)
+    {
+#if !HAVE_UG_PATCH10
+      DUNE_THROW(NotImplemented, "load balancing with data attached");
+#else
+#ifdef ModelP
+      UGLBGatherScatter::template gather<dim>(this->leafView(), dataHandle);
+#endif
+
+      loadBalance(targetProcessors, fromLevel);
+
+#ifdef ModelP
+      UGLBGatherScatter::template scatter<dim>(this->leafView(), dataHandle);
+#endif
+
+      return true;
+#endif  // HAVE_UG_PATCH10
+    }
+
+    /** \brief Distribute the grid by partitioning the dual graph of the leaf elements
+
+       The interior leaf elements are split into comm().size() parts of about
+       equal weight and small interface by the given partitioner, see
+       partitionDualGraph().
+
+       \param weight functor returning the weight of a leaf element
+       \param fromLevel the coarsest level that gets redistributed
+     */
+    template<class Weight>
+    bool loadBalance (const GraphPartitioner& partitioner, const Weight& weight, int fromLevel = 0)
+    {
+      std::vector<int> targetProcessors;
+      partitionDualGraph(this->leafView(), weight, partitioner, targetProcessors);
+      return loadBalance(targetProcessors, fromLevel);
+    }
+
+    /** \brief Distribute the grid by partitioning the dual graph, and transfer data with the elements */
+    template<class Weight, class DataHandle>
+    bool loadBalance (const GraphPartitioner& partitioner, const Weight& weight, int fromLevel, DataHandle& dataHandle)
+    {
+      std::vector<int> targetProcessors;
+      partitionDualGraph(this->leafView(), weight, partitioner, targetProcessors);
+      return loadBalance(targetProcessors, fromLevel, dataHandle);
+    }
+
     /** \brief The communication interface for all codims on a given level
        @param dataHandle type used to gather/scatter data in and out of the message buffer
        @param iftype one of the predifined interface types, throws error if it is not implemented
@@ -638,6 +711,15 @@ namespace Dune {
       else
         ugIfDir = UG_NS<dim>::IF_BACKWARD();
 
+      // Fixed-size data of elements and vertices is sent in one block per process
+      if (dataHandle.fixedsize(dim, codim) && UGCommInterface<dim,codim>::supported(iftype)
+          && (codim == 0 || codim == dim))
+      {
+        communicateFixedSize_<GridView, DataHandle, codim>(gv, level, dataHandle, iftype, dir,
+                                                           integral_constant<bool, codim == 0 || codim == dim>());
+        return;
+      }
+
       typedef UGMessageBuffer<DataHandle,dim,codim> UGMsgBuf;
       UGMsgBuf::duneDataHandle_ = &dataHandle;
 
@@ -657,6 +739,40 @@ namespace Dune {
                                  &UGMsgBuf::ugScatter_);
     }
 
+    /** \brief Communicate fixed-size data over a precomputed interface, see UGCommInterface
+
+       The interfaces are set up at the first communication after each grid change.
+     */
+    template <class GridView, class DataHandle, int codim>
+    void communicateFixedSize_(const GridView& gv, int level,
+                               DataHandle &dataHandle,
+                               InterfaceType iftype,
+                               CommunicationDirection dir,
+                               integral_constant<bool, true>) const
+    {
+      shared_ptr<void>& cached = commInterfaces_[std::make_pair(std::make_pair(level, codim),
+                                                                 std::make_pair(int(iftype), int(dir)))];
+      if (!cached) {
+        // all processes get here at the same time, so the communicator can be duplicated
+        if (!commInterfaceComm_)
+          commInterfaceComm_ = make_shared<UGCommInterfaceCommunicator>();
+        shared_ptr<UGCommInterface<dim,codim> > interface = make_shared<UGCommInterface<dim,codim> >(commInterfaceComm_);
+        interface->build(gv, iftype, dir);
+        cached = interface;
+      }
+      static_cast<const UGCommInterface<dim,codim>*>(cached.get())->exchange(dataHandle, this);
+    }
+
+    template <class GridView, class DataHandle, int codim>
+    void communicateFixedSize_(const GridView& gv, int level,
+                               DataHandle &dataHandle,
+                               InterfaceType iftype,
+                               CommunicationDirection dir,
+                               integral_constant<bool, false>) const
+    {
+      DUNE_THROW(NotImplemented, "fixed-size communication for codim " << codim);
+    }
+
     void findDDDInterfaces_(std::vector<typename UG_NS<dim>::DDD_IF > &dddIfaces,
                             InterfaceType iftype,
                             int codim) const
@@ -799,6 +915,48 @@ namespace Dune {
       closureType_ = type;
     }
 
+    /** \brief Update the leaf indices incrementally after adaptation
+
+       If this is set, adapt() keeps the leaf indices of all entities that stay in the
+       leaf grid, gives indices to the new entities and moves only as many entities as
+       needed to close the holes.  The map from the old to the new indices can be queried
+       with leafIndexMap().  Otherwise all leaf entities are numbered anew.
+
+       The update still visits all elements of all levels, so its cost grows with the size
+       of the grid; what is saved is the data that has to be moved because of changed indices.
+     */
+    void setIncrementalLeafIndexUpdate(bool incremental) {
+      // The keys of the current indices are only recorded in incremental mode
+      if (incremental && !incrementalLeafIndexUpdate_)
+        leafIndexSet_.recordLeafKeys();
+      incrementalLeafIndexUpdate_ = incremental;
+    }
+
+    /** \brief Map from the leaf indices before the last adaptation to the current ones
+
+       Entry i is the current leaf index of the entity of the given type which had index i
+       before, or -1 if that entity has left the leaf grid.  The map is empty unless the
+       leaf indices have been updated incrementally, see setIncrementalLeafIndexUpdate().
+     */
+    const std::vector<int>& leafIndexMap(const GeometryType& type) const {
+      return leafIndexSet_.indexMap(type);
+    }
+
+    /** \brief Cache the geometry data of the leaf elements
+
+       If this is set, the corners and volumes of all leaf elements, and the Jacobians of
+       the affine ones, are computed once after each change of the grid and then taken from
+       the cache by the element geometries.  The cache is recomputed on the first geometry
+       access after adapt(), loadBalance() or setPosition().  Geometry objects obtained
+       before such a change must not be used afterwards.
+     */
+    void setGeometryCaching(bool caching) {
+      geometryCaching_ = caching;
+      geometryCacheIsOutdated_ = true;
+      if (!caching)
+        geometryCache_.clear();
+    }
+
     /** \brief Sets the default heap size
      *
      * UGGrid keeps an internal heap to allocate memory from, which must be
@@ -823,13 +981,13 @@ namespace Dune {
 
     /** \brief Save entire grid hierarchy to disk
 
-       Test implementation -- not working!
+       Test implementation -- not working!  Use BackupRestoreFacility<UGGrid> instead.
      */
     void saveState(const std::string& filename) const;
 
     /** \brief Read entire grid hierarchy from disk
 
-       Test implementation -- not working!
+       Test implementation -- not working!  Use BackupRestoreFacility<UGGrid> instead.
      */
     void loadState(const std::string& filename);
 
@@ -848,6 +1006,21 @@ namespace Dune {
     void setIndices(bool setLevelZero,
                     std::vector<unsigned int>* nodePermutation);
 
+    /** \brief The cached geometry data of a leaf element, or NULL if there is none */
+    const UGGridGeometryCacheEntry<dim>* geometryCacheEntry(const typename UG_NS<dim>::Element* target) const
+    {
+      if (!geometryCaching_ || !target || !UG_NS<dim>::isLeaf(target))
+        return NULL;
+
+      if (geometryCacheIsOutdated_) {
+        // Reset the flag first: the update itself creates element geometries
+        geometryCacheIsOutdated_ = false;
+        geometryCache_.update(*this);
+      }
+
+      return geometryCache_.entry(UG_NS<dim>::Corners_Of_Elem(target), UG_NS<dim>::leafIndex(target));
+    }
+
     // Each UGGrid object has a unique name to identify it in the
     // UG environment structure
     std::string name_;
@@ -857,6 +1030,15 @@ namespace Dune {
 
     UGGridLeafIndexSet<const UGGrid<dim> > leafIndexSet_;
 
+#ifdef ModelP
+    /** \brief The interfaces used for fixed-size communication, by level (-1 for the leaf),
+        codim, interface type and direction.  Cleared whenever the grid changes. */
+    mutable std::map<std::pair<std::pair<int,int>, std::pair<int,int> >, shared_ptr<void> > commInterfaces_;
+
+    /** \brief The communicator of the interfaces, duplicated once at their first use */
+    mutable shared_ptr<UGCommInterfaceCommunicator> commInterfaceComm_;
+#endif
+
     // One id set implementation
     // Used for both the local and the global UGGrid id sets
     UGGridIdSet<const UGGrid<dim> > idSet_;
@@ -867,6 +1049,18 @@ namespace Dune {
     //! The type of grid refinement closure currently in use
     ClosureType closureType_;
 
+    //! Whether adapt() updates the leaf indices incrementally
+    bool incrementalLeafIndexUpdate_;
+
+    //! Whether the geometry data of the leaf elements is cached
+    bool geometryCaching_;
+
+    //! Whether the grid has changed since the geometry cache was computed
+    mutable bool geometryCacheIsOutdated_;
+
+    //! The geometry data of the leaf elements, see setGeometryCaching()
+    mutable UGGridGeometryCache<dim> geometryCache_;
+
     /** \brief Number of UGGrids currently in use.
      *
      * This counts the number of UGGrids currently instantiated.  All
@@ -953,6 +1147,15 @@ namespace Dune {
 #endif // !ModelP
     };
 
+    /** \brief UGGrid has backup and restore facilities
+       \ingroup UGGrid
+     */
+    template<int dim>
+    struct hasBackupRestoreFacilities< UGGrid<dim> >
+    {
+      static const bool v = true;
+    };
+
     /** \brief UGGrid is levelwise conforming
        \ingroup UGGrid
      */
@@ -0,0 +1,624 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_UGGRID_BACKUPRESTORE_HH
+#define DUNE_UGGRID_BACKUPRESTORE_HH
+
+/** \file
+    \brief Binary backup and restore of UGGrid hierarchies
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/geometry/type.hh>
+
+#include <dune/grid/common/backuprestore.hh>
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/gridfactory.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+
+namespace Dune
+{
+
+  template <int dim>
+  class UGGrid;
+
+  /** \brief BackupRestoreFacility for UGGrid
+
+     Each process writes its part of the grid into a compact binary stream: the
+     interior coarse grid elements with their vertices, the interior elements that
+     have been refined regularly, and the interior leaf elements.  Elements are
+     identified by their position in the hierarchy, i.e., by the id of their coarse
+     grid ancestor and the child numbers on the way down.  A child number is the set
+     of the father's context nodes (corners, edge and side midpoints, center) that
+     are corners of the child, so it does not depend on coordinates or on the order
+     of the elements on the processes.
+
+     On restore the coarse grid is built on rank 0, because the grid factory works
+     there only, and each coarse grid element is sent back to the process that
+     backed it up.  The paths of the refined and the leaf elements are sent to the
+     owners of their coarse grid ancestors, which replay the refinement level by
+     level.  Finally each leaf element is sent to the process it was on.  Hence the
+     leaf partition is reproduced even if the refinement trees of the coarse grid
+     elements were split between the processes, while no process holds more than
+     the coarse grid and its own refinement trees.
+
+     Backup and restore are collective operations.  Restoring requires the same
+     number of processes as the backup.  In parallel the file methods append the
+     rank to the file name.
+
+     The restored grid has the same leaf elements on each process, with the same
+     geometries, refinement type and closure type.  However, the grid is rebuilt
+     from scratch, so the index sets and the id sets are numbered anew, and the
+     linear boundary segments may be numbered differently.  Refinement is replayed
+     with mark(1,element), so anisotropic refinement rules are not reproduced.
+     Grids with parametrized boundaries cannot be backed up.
+   */
+  template <int dim>
+  struct BackupRestoreFacility<UGGrid<dim> >
+  {
+    typedef UGGrid<dim> Grid;
+
+    /** \copydoc Dune::BackupRestoreFacility::backup(grid,filename) */
+    static void backup ( const Grid &grid, const std::string &filename )
+    {
+      std::ofstream file( rankFilename( filename, grid.comm() ).c_str(), std::ios::binary );
+      if( !file )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: couldn't open file '" << filename << "'" );
+      backup( grid, file );
+    }
+
+    /** \copydoc Dune::BackupRestoreFacility::backup(grid,stream) */
+    static void backup ( const Grid &grid, std::ostream &stream )
+    {
+      typedef typename Grid::template Codim<0>::template Partition<Interior_Partition>::LevelIterator LevelIterator;
+      typedef typename Grid::template Codim<0>::template Partition<Interior_Partition>::LeafIterator LeafIterator;
+
+      if( !grid.boundarySegments_.empty() )
+        DUNE_THROW( NotImplemented, "BackupRestoreFacility<UGGrid>: backup of grids with parametrized boundaries" );
+
+      const int maxLevel = grid.comm().max( grid.maxLevel() );
+
+      stream.write( magic(), std::strlen( magic() ) );
+      write( stream, int(version) );
+      write( stream, int(dim) );
+      write( stream, grid.comm().size() );
+      write( stream, grid.comm().rank() );
+      write( stream, int(grid.refinementType_) );
+      write( stream, int(grid.closureType_) );
+      write( stream, maxLevel );
+
+      // the interior coarse grid elements and their vertices
+      std::map<IdType, unsigned int> vertexIndex;
+      std::vector<IdType> macroIds;
+      std::vector<IdType> vertexIds;
+      std::vector<double> coordinates;
+      std::vector<unsigned char> numCorners;
+      std::vector<unsigned int> corners;
+
+      const LevelIterator end = grid.template lend<0,Interior_Partition>( 0 );
+      for( LevelIterator it = grid.template lbegin<0,Interior_Partition>( 0 ); it != end; ++it )
+      {
+        macroIds.push_back( grid.globalIdSet().id( *it ) );
+        numCorners.push_back( it->geometry().corners() );
+        for( int i = 0; i < it->geometry().corners(); ++i )
+        {
+          const IdType id = grid.globalIdSet().subId( *it, i, dim );
+          typename std::map<IdType, unsigned int>::iterator v = vertexIndex.find( id );
+          if( v == vertexIndex.end() )
+          {
+            v = vertexIndex.insert( std::make_pair( id, (unsigned int)vertexIds.size() ) ).first;
+            vertexIds.push_back( id );
+            for( int k = 0; k < dim; ++k )
+              coordinates.push_back( it->geometry().corner( i )[ k ] );
+          }
+          corners.push_back( v->second );
+        }
+      }
+
+      writeVector( stream, macroIds );
+      writeVector( stream, vertexIds );
+      writeVector( stream, coordinates );
+      writeVector( stream, numCorners );
+      writeVector( stream, corners );
+
+      // the paths of the interior elements which have been refined regularly
+      std::vector<IdType> macros;
+      std::vector<unsigned int> paths;
+      for( int level = 0; level < std::min( maxLevel, grid.maxLevel()+1 ); ++level )
+      {
+        const LevelIterator levelEnd = grid.template lend<0,Interior_Partition>( level );
+        for( LevelIterator it = grid.template lbegin<0,Interior_Partition>( level ); it != levelEnd; ++it )
+          if( UG_NS<dim>::isRedRefined( grid.getRealImplementation( *it ).getTarget() ) )
+            appendPath( grid, *it, macros, paths );
+      }
+      writeVector( stream, macros );
+      writeVector( stream, paths );
+
+      // the paths of the interior leaf elements, which are sent back here on restore
+      macros.clear();
+      paths.clear();
+      const LeafIterator leafEnd = grid.template leafend<0,Interior_Partition>();
+      for( LeafIterator it = grid.template leafbegin<0,Interior_Partition>(); it != leafEnd; ++it )
+        appendPath( grid, *it, macros, paths );
+      writeVector( stream, macros );
+      writeVector( stream, paths );
+
+      if( !stream )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: writing the backup failed" );
+    }
+
+    /** \copydoc Dune::BackupRestoreFacility::restore(filename) */
+    static Grid *restore ( const std::string &filename )
+    {
+      std::ifstream file( rankFilename( filename, MPIHelper::getCollectiveCommunication() ).c_str(), std::ios::binary );
+      if( !file )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: couldn't open file '" << filename << "'" );
+      return restore( file );
+    }
+
+    /** \copydoc Dune::BackupRestoreFacility::restore(stream) */
+    static Grid *restore ( std::istream &stream )
+    {
+      typedef typename Grid::template Codim<0>::LevelIterator LevelIterator;
+      typedef typename Grid::template Codim<0>::template Partition<Interior_Partition>::LevelIterator InteriorLevelIterator;
+      typedef typename Grid::template Codim<0>::template Partition<Interior_Partition>::LeafIterator InteriorLeafIterator;
+
+      const CollectiveCommunication<MPIHelper::MPICommunicator> cc = MPIHelper::getCollectiveCommunication();
+
+      std::vector<char> header( std::strlen( magic() ) );
+      stream.read( &header[ 0 ], header.size() );
+      if( !stream || std::string( header.begin(), header.end() ) != magic() )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: the stream does not contain a UGGrid backup" );
+
+      int fileVersion, fileDim, size, rank, refinementType, closureType, maxLevel;
+      read( stream, fileVersion );
+      read( stream, fileDim );
+      read( stream, size );
+      read( stream, rank );
+      read( stream, refinementType );
+      read( stream, closureType );
+      read( stream, maxLevel );
+      if( fileVersion != version )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: cannot read backup version " << fileVersion );
+      if( fileDim != dim )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: the backup contains a " << fileDim << "d grid" );
+      if( size != cc.size() || rank != cc.rank() )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: the backup of rank " << rank << " out of " << size
+                                                                                      << " processes cannot be restored on rank " << cc.rank() << " out of " << cc.size() );
+
+      std::vector<IdType> macroIds;
+      std::vector<IdType> vertexIds;
+      std::vector<double> coordinates;
+      std::vector<unsigned char> numCorners;
+      std::vector<unsigned int> corners;
+      readVector( stream, macroIds );
+      readVector( stream, vertexIds );
+      readVector( stream, coordinates );
+      readVector( stream, numCorners );
+      readVector( stream, corners );
+
+      std::vector<IdType> refinedMacros, leafMacros;
+      std::vector<unsigned int> refinedPaths, leafPaths;
+      readVector( stream, refinedMacros );
+      readVector( stream, refinedPaths );
+      readVector( stream, leafMacros );
+      readVector( stream, leafPaths );
+
+      // every process needs to know who owns which coarse grid element
+      std::vector<std::vector<IdType> > allMacroIds;
+      allgather( cc, macroIds, allMacroIds );
+      std::map<IdType, std::pair<int, unsigned int> > macroOwners;
+      for( int p = 0; p < cc.size(); ++p )
+        for( std::size_t k = 0; k < allMacroIds[ p ].size(); ++k )
+          macroOwners[ allMacroIds[ p ][ k ] ] = std::make_pair( p, (unsigned int)k );
+
+      // build the coarse grid on rank 0, inserting the elements of each process in turn
+      std::vector<std::vector<IdType> > allVertexIds;
+      std::vector<std::vector<double> > allCoordinates;
+      std::vector<std::vector<unsigned char> > allNumCorners;
+      std::vector<std::vector<unsigned int> > allCorners;
+      gather( cc, vertexIds, allVertexIds );
+      gather( cc, coordinates, allCoordinates );
+      gather( cc, numCorners, allNumCorners );
+      gather( cc, corners, allCorners );
+
+      GridFactory<Grid> factory;
+      if( cc.rank() == 0 )
+      {
+        std::map<IdType, unsigned int> vertexIndex;
+        std::vector<double> uniqueCoordinates;
+        std::vector<unsigned int> vertices;
+        for( int p = 0; p < cc.size(); ++p )
+        {
+          std::vector<unsigned int> localToGlobal( allVertexIds[ p ].size() );
+          for( std::size_t i = 0; i < allVertexIds[ p ].size(); ++i )
+          {
+            typename std::map<IdType, unsigned int>::iterator v = vertexIndex.find( allVertexIds[ p ][ i ] );
+            if( v == vertexIndex.end() )
+            {
+              v = vertexIndex.insert( std::make_pair( allVertexIds[ p ][ i ], (unsigned int)vertexIndex.size() ) ).first;
+              uniqueCoordinates.insert( uniqueCoordinates.end(), allCoordinates[ p ].begin() + i*dim, allCoordinates[ p ].begin() + (i+1)*dim );
+            }
+            localToGlobal[ i ] = v->second;
+          }
+
+          std::size_t offset = 0;
+          for( std::size_t i = 0; i < allNumCorners[ p ].size(); ++i )
+          {
+            vertices.resize( allNumCorners[ p ][ i ] );
+            for( std::size_t j = 0; j < vertices.size(); ++j )
+              vertices[ j ] = localToGlobal[ allCorners[ p ][ offset++ ] ];
+            factory.insertElement( elementType( vertices.size() ), vertices );
+          }
+        }
+        factory.insertVertices( uniqueCoordinates );
+      }
+
+      Grid *grid = factory.createGrid();
+      grid->setRefinementType( typename Grid::RefinementType( refinementType ) );
+      grid->setClosureType( typename Grid::ClosureType( closureType ) );
+
+      // send each coarse grid element to the process it came from, and tell that process its new id
+      std::vector<std::vector<IdType> > newMacroIds( cc.size() );
+      {
+        const LeafMultipleCodimMultipleGeomTypeMapper<Grid, MCMGElementLayout> mapper( *grid );
+        std::vector<int> targetProcessors( mapper.size(), 0 );
+        if( cc.rank() == 0 )
+        {
+          std::vector<unsigned int> offsets( cc.size()+1, 0 );
+          for( int p = 0; p < cc.size(); ++p )
+          {
+            offsets[ p+1 ] = offsets[ p ] + allMacroIds[ p ].size();
+            newMacroIds[ p ].resize( allMacroIds[ p ].size() );
+          }
+
+          const LevelIterator end = grid->template lend<0>( 0 );
+          for( LevelIterator it = grid->template lbegin<0>( 0 ); it != end; ++it )
+          {
+            const unsigned int index = factory.insertionIndex( *it );
+            const int p = std::upper_bound( offsets.begin(), offsets.end(), index ) - offsets.begin() - 1;
+            targetProcessors[ mapper.map( *it ) ] = p;
+            newMacroIds[ p ][ index - offsets[ p ] ] = grid->globalIdSet().id( *it );
+          }
+        }
+        grid->loadBalance( targetProcessors, 0 );
+      }
+
+      std::vector<std::vector<IdType> > receivedIds;
+      exchange( cc, newMacroIds, receivedIds );
+      std::map<IdType, unsigned int> macroIndex;
+      for( std::size_t k = 0; k < receivedIds[ 0 ].size(); ++k )
+        macroIndex[ receivedIds[ 0 ][ k ] ] = k;
+
+      // send the paths to the owners of their coarse grid elements
+      std::vector<std::vector<unsigned int> > records( cc.size() );
+      appendRecords( macroOwners, refinedMacros, refinedPaths, false, records );
+      appendRecords( macroOwners, leafMacros, leafPaths, true, records );
+      std::vector<std::vector<unsigned int> > receivedRecords;
+      exchange( cc, records, receivedRecords );
+
+      std::vector<std::set<Path> > refined( std::max( maxLevel, 0 ) );
+      std::map<Path, int> leafRanks;
+      for( int p = 0; p < cc.size(); ++p )
+      {
+        const std::vector<unsigned int> &r = receivedRecords[ p ];
+        for( std::size_t i = 0; i+3 <= r.size(); i += 3 + r[ i+2 ] )
+        {
+          const unsigned int level = r[ i+2 ];
+          Path path( 1, r[ i+1 ] );
+          path.insert( path.end(), r.begin() + i+3, r.begin() + i+3 + level );
+          if( r[ i ] )
+            leafRanks.insert( std::make_pair( path, p ) );
+          else if( int(level) < maxLevel )
+            refined[ level ].insert( path );
+        }
+      }
+
+      // replay the refinement of the coarse grid elements owned by this process
+      Path path;
+      for( int level = 0; level < maxLevel; ++level )
+      {
+        std::size_t found = 0;
+        if( level <= grid->maxLevel() )
+        {
+          const InteriorLevelIterator end = grid->template lend<0,Interior_Partition>( level );
+          for( InteriorLevelIterator it = grid->template lbegin<0,Interior_Partition>( level ); it != end; ++it )
+          {
+            elementPath( *grid, *it, macroIndex, path );
+            if( refined[ level ].count( path ) && grid->mark( 1, *it ) )
+              ++found;
+          }
+        }
+        if( cc.max( int(found != refined[ level ].size()) ) )
+          DUNE_THROW( GridError, "BackupRestoreFacility<UGGrid>: the restored hierarchy differs from the backup on level " << level );
+
+        grid->preAdapt();
+        grid->adapt();
+        grid->postAdapt();
+      }
+
+      // send the leaf elements back to the processes they came from
+      const LeafMultipleCodimMultipleGeomTypeMapper<Grid, MCMGElementLayout> mapper( *grid );
+      std::vector<int> targetProcessors( mapper.size(), cc.rank() );
+      std::size_t found = 0;
+      const InteriorLeafIterator leafEnd = grid->template leafend<0,Interior_Partition>();
+      for( InteriorLeafIterator it = grid->template leafbegin<0,Interior_Partition>(); it != leafEnd; ++it )
+      {
+        elementPath( *grid, *it, macroIndex, path );
+        const typename std::map<Path, int>::const_iterator leaf = leafRanks.find( path );
+        if( leaf == leafRanks.end() )
+          continue;
+        targetProcessors[ mapper.map( *it ) ] = leaf->second;
+        ++found;
+      }
+      if( cc.max( int(found != leafRanks.size()) ) )
+        DUNE_THROW( GridError, "BackupRestoreFacility<UGGrid>: the restored leaf elements differ from the backup" );
+      grid->loadBalance( targetProcessors, 0 );
+
+      return grid;
+    }
+
+  private:
+    typedef unsigned long long IdType;
+
+    //! the index of the coarse grid ancestor on its process, followed by the child numbers
+    typedef std::vector<unsigned int> Path;
+
+    //! the version of the binary format
+    static const int version = 3;
+
+    static const char *magic ()
+    {
+      return "UGGridBackup";
+    }
+
+    /** \brief The position of an element in its father
+
+       This is the bit set of the nodes in the father's context that are corners
+       of the element.  UG orders the context by the refinement rule, so the number
+       is the same on all processes and in every copy of the hierarchy.
+     */
+    template< class Element >
+    static unsigned int childNumber ( const Grid &grid, const Element &element )
+    {
+      const int contextSize = 8 + (dim == 2 ? 5 : 19);
+      const typename UG_NS<dim>::Node *context[ contextSize ];
+      const typename UG_NS<dim>::Element *target = grid.getRealImplementation( element ).getTarget();
+      UG_NS<dim>::GetNodeContext( UG_NS<dim>::EFather( target ), context );
+
+      unsigned int number = 0;
+      for( int i = 0; i < UG_NS<dim>::Corners_Of_Elem( target ); ++i )
+      {
+        const int j = std::find( context, context + contextSize, UG_NS<dim>::Corner( target, i ) ) - context;
+        if( j == contextSize )
+          DUNE_THROW( GridError, "BackupRestoreFacility<UGGrid>: corner not found in the context of the father" );
+        number |= 1u << j;
+      }
+      return number;
+    }
+
+    //! return the id of the coarse grid ancestor and store the child numbers from there down to the element
+    template< class Element, class Iterator >
+    static IdType ancestry ( const Grid &grid, const Element &element, Iterator children )
+    {
+      typedef typename Grid::template Codim<0>::EntityPointer EntityPointer;
+
+      if( element.level() == 0 )
+        return grid.globalIdSet().id( element );
+
+      children[ element.level()-1 ] = childNumber( grid, element );
+      EntityPointer ancestor = element.father();
+      for( ; ancestor->level() > 0; ancestor = ancestor->father() )
+        children[ ancestor->level()-1 ] = childNumber( grid, *ancestor );
+      return grid.globalIdSet().id( *ancestor );
+    }
+
+    //! append the ancestor id and the level followed by the child numbers of an element
+    template< class Element >
+    static void appendPath ( const Grid &grid, const Element &element, std::vector<IdType> &macros, std::vector<unsigned int> &paths )
+    {
+      const std::size_t offset = paths.size();
+      paths.resize( offset + 1 + element.level() );
+      paths[ offset ] = element.level();
+      macros.push_back( ancestry( grid, element, paths.begin() + offset + 1 ) );
+    }
+
+    //! the path of an element of the restored grid, with the index of its ancestor among the coarse elements of this process
+    template< class Element >
+    static void elementPath ( const Grid &grid, const Element &element, const std::map<IdType, unsigned int> &macroIndex, Path &path )
+    {
+      path.resize( element.level()+1 );
+      const typename std::map<IdType, unsigned int>::const_iterator macro = macroIndex.find( ancestry( grid, element, path.begin() + 1 ) );
+      path[ 0 ] = (macro != macroIndex.end() ? macro->second : std::numeric_limits<unsigned int>::max());
+    }
+
+    //! sort the paths by the owner of their coarse grid ancestor: leaf flag, index of the ancestor, level, child numbers
+    static void appendRecords ( const std::map<IdType, std::pair<int, unsigned int> > &macroOwners,
+                                const std::vector<IdType> &macros, const std::vector<unsigned int> &paths,
+                                bool leaf, std::vector<std::vector<unsigned int> > &records )
+    {
+      std::size_t offset = 0;
+      for( std::size_t i = 0; i < macros.size(); ++i )
+      {
+        const typename std::map<IdType, std::pair<int, unsigned int> >::const_iterator owner = macroOwners.find( macros[ i ] );
+        if( owner == macroOwners.end() || offset >= paths.size() )
+          DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: the backup refers to an unknown coarse grid element" );
+
+        const unsigned int level = paths[ offset ];
+        std::vector<unsigned int> &r = records[ owner->second.first ];
+        r.push_back( leaf );
+        r.push_back( owner->second.second );
+        r.insert( r.end(), paths.begin() + offset, paths.begin() + offset + 1 + level );
+        offset += 1 + level;
+      }
+    }
+
+    template< class Comm >
+    static std::string rankFilename ( const std::string &filename, const Comm &comm )
+    {
+      if( comm.size() == 1 )
+        return filename;
+      std::ostringstream s;
+      s << filename << "." << comm.rank();
+      return s.str();
+    }
+
+    //! the geometry type of a UGGrid element with the given number of corners
+    static GeometryType elementType ( std::size_t numCorners )
+    {
+      if( dim == 2 )
+        return GeometryType( numCorners == 3 ? GeometryType::simplex : GeometryType::cube, dim );
+
+      switch( numCorners )
+      {
+      case 4 : return GeometryType( GeometryType::simplex, dim );
+      case 5 : return GeometryType( GeometryType::pyramid, dim );
+      case 6 : return GeometryType( GeometryType::prism, dim );
+      case 8 : return GeometryType( GeometryType::cube, dim );
+      default :
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: invalid element with " << numCorners << " corners" );
+      }
+    }
+
+    template< class T >
+    static void write ( std::ostream &stream, const T &value )
+    {
+      stream.write( reinterpret_cast<const char *>( &value ), sizeof( T ) );
+    }
+
+    template< class T >
+    static void read ( std::istream &stream, T &value )
+    {
+      stream.read( reinterpret_cast<char *>( &value ), sizeof( T ) );
+      if( !stream )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: unexpected end of the backup" );
+    }
+
+    template< class T >
+    static void writeVector ( std::ostream &stream, const std::vector<T> &values )
+    {
+      write( stream, (unsigned int)values.size() );
+      if( !values.empty() )
+        stream.write( reinterpret_cast<const char *>( &values[ 0 ] ), values.size()*sizeof( T ) );
+    }
+
+    template< class T >
+    static void readVector ( std::istream &stream, std::vector<T> &values )
+    {
+      unsigned int size;
+      read( stream, size );
+      values.resize( size );
+      if( size > 0 )
+        stream.read( reinterpret_cast<char *>( &values[ 0 ] ), size*sizeof( T ) );
+      if( !stream )
+        DUNE_THROW( IOError, "BackupRestoreFacility<UGGrid>: unexpected end of the backup" );
+    }
+
+    //! gather the vectors of all processes on rank 0, as bytes padded to the longest one
+    template< class Comm, class T >
+    static void gather ( const Comm &comm, const std::vector<T> &values, std::vector<std::vector<T> > &allValues )
+    {
+      const int size = values.size();
+      const int maxSize = comm.max( size );
+
+      std::vector<int> sizes( comm.size() );
+      comm.gather( const_cast<int *>( &size ), &sizes[ 0 ], 1, 0 );
+
+      std::vector<char> bytes( std::max( maxSize, 1 )*sizeof( T ) );
+      if( size > 0 )
+        std::memcpy( &bytes[ 0 ], &values[ 0 ], size*sizeof( T ) );
+      std::vector<char> allBytes( bytes.size()*comm.size() );
+      comm.gather( &bytes[ 0 ], &allBytes[ 0 ], bytes.size(), 0 );
+
+      allValues.clear();
+      if( comm.rank() != 0 )
+        return;
+      allValues.resize( comm.size() );
+      for( int p = 0; p < comm.size(); ++p )
+      {
+        allValues[ p ].resize( sizes[ p ] );
+        if( sizes[ p ] > 0 )
+          std::memcpy( &allValues[ p ][ 0 ], &allBytes[ p*bytes.size() ], sizes[ p ]*sizeof( T ) );
+      }
+    }
+
+    //! gather the vectors of all processes on all processes, as bytes padded to the longest one
+    template< class Comm, class T >
+    static void allgather ( const Comm &comm, const std::vector<T> &values, std::vector<std::vector<T> > &allValues )
+    {
+      const int size = values.size();
+      const int maxSize = comm.max( size );
+
+      std::vector<int> sizes( comm.size() );
+      comm.allgather( const_cast<int *>( &size ), 1, &sizes[ 0 ] );
+
+      std::vector<char> bytes( std::max( maxSize, 1 )*sizeof( T ) );
+      if( size > 0 )
+        std::memcpy( &bytes[ 0 ], &values[ 0 ], size*sizeof( T ) );
+      std::vector<char> allBytes( bytes.size()*comm.size() );
+      comm.allgather( &bytes[ 0 ], bytes.size(), &allBytes[ 0 ] );
+
+      allValues.resize( comm.size() );
+      for( int p = 0; p < comm.size(); ++p )
+      {
+        allValues[ p ].resize( sizes[ p ] );
+        if( sizes[ p ] > 0 )
+          std::memcpy( &allValues[ p ][ 0 ], &allBytes[ p*bytes.size() ], sizes[ p ]*sizeof( T ) );
+      }
+    }
+
+    //! send values[ p ] to process p and receive the values of process p in received[ p ]
+    template< class Comm, class T >
+    static void exchange ( const Comm &comm, const std::vector<std::vector<T> > &values, std::vector<std::vector<T> > &received )
+    {
+      received.assign( comm.size(), std::vector<T>() );
+#if HAVE_MPI
+      if( comm.size() > 1 )
+      {
+        std::vector<int> sendCounts( comm.size() ), sendOffsets( comm.size()+1, 0 );
+        for( int p = 0; p < comm.size(); ++p )
+        {
+          sendCounts[ p ] = values[ p ].size()*sizeof( T );
+          sendOffsets[ p+1 ] = sendOffsets[ p ] + sendCounts[ p ];
+        }
+        std::vector<int> recvCounts( comm.size() ), recvOffsets( comm.size()+1, 0 );
+        MPI_Alltoall( &sendCounts[ 0 ], 1, MPI_INT, &recvCounts[ 0 ], 1, MPI_INT, comm );
+        for( int p = 0; p < comm.size(); ++p )
+          recvOffsets[ p+1 ] = recvOffsets[ p ] + recvCounts[ p ];
+
+        std::vector<char> sendBytes( std::max( sendOffsets.back(), 1 ) );
+        std::vector<char> recvBytes( std::max( recvOffsets.back(), 1 ) );
+        for( int p = 0; p < comm.size(); ++p )
+          if( sendCounts[ p ] > 0 )
+            std::memcpy( &sendBytes[ sendOffsets[ p ] ], &values[ p ][ 0 ], sendCounts[ p ] );
+        MPI_Alltoallv( &sendBytes[ 0 ], &sendCounts[ 0 ], &sendOffsets[ 0 ], MPI_BYTE,
+                       &recvBytes[ 0 ], &recvCounts[ 0 ], &recvOffsets[ 0 ], MPI_BYTE, comm );
+
+        for( int p = 0; p < comm.size(); ++p )
+        {
+          received[ p ].resize( recvCounts[ p ] / sizeof( T ) );
+          if( recvCounts[ p ] > 0 )
+            std::memcpy( &received[ p ][ 0 ], &recvBytes[ recvOffsets[ p ] ], recvCounts[ p ] );
+        }
+        return;
+      }
+#endif
+      received[ comm.rank() ] = values[ comm.rank() ];
+    }
+  };
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_UGGRID_BACKUPRESTORE_HH
@@ -0,0 +1,325 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef UG_COMM_INTERFACE_HH
+#define UG_COMM_INTERFACE_HH
+
+/** \file
+    \brief Precomputed communication interfaces for fixed-size data on UGGrid
+ */
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/shared_ptr.hh>
+
+#include <dune/grid/common/gridenums.hh>
+
+namespace Dune {
+
+  /** \brief A private duplicate of the communicator of UGGrid for the messages of UGCommInterface
+
+     The interfaces use fixed message tags.  On their own communicator these cannot
+     match messages of the application or of other libraries.  Creating and freeing
+     it are collective operations.
+   */
+  class UGCommInterfaceCommunicator
+  {
+  public:
+    UGCommInterfaceCommunicator ()
+    {
+      MPI_Comm_dup(MPIHelper::getCommunicator(), &comm_);
+    }
+
+    ~UGCommInterfaceCommunicator ()
+    {
+      int finalized;
+      MPI_Finalized(&finalized);
+      if (!finalized)
+        MPI_Comm_free(&comm_);
+    }
+
+    //! The duplicated communicator
+    MPI_Comm get () const
+    {
+      return comm_;
+    }
+
+  private:
+    // not copyable, the communicator is freed once
+    UGCommInterfaceCommunicator (const UGCommInterfaceCommunicator&);
+    UGCommInterfaceCommunicator& operator= (const UGCommInterfaceCommunicator&);
+
+    MPI_Comm comm_;
+  };
+
+  /** \brief The entities of one UGGrid communication interface, grouped by the processes they are exchanged with
+
+     The interface is set up once for a grid view, codimension, interface type and
+     direction.  Afterwards data handles with fixed-size data are communicated with one
+     contiguous message per neighboring process, without going through the DDD
+     callbacks, see UGMessageBuffer.  The entities of the messages are ordered by their
+     DDD global ids, which are the same on all processes.
+
+     Setting up the interface is a collective operation.  It has to be done anew after
+     each change of the grid.  All messages go over the communicator given to the
+     constructor, which the interfaces of a grid share.
+   */
+  template <int dim, int codim>
+  class UGCommInterface
+  {
+    typedef typename UG_NS<dim>::template Entity<codim>::T UGEntity;
+    typedef typename UG_NS<dim>::UG_ID_TYPE GID;
+    typedef std::pair<GID, UGEntity*> Candidate;
+
+    // tags for the messages to set up the interface and to exchange the data,
+    // they are only used on the private communicator
+    enum { gidTag = 4711, positionTag = 4712, dataTag = 4713 };
+
+    /** \brief Message buffer writing to and reading from contiguous memory */
+    template <class DataType>
+    class Buffer
+    {
+    public:
+      explicit Buffer (DataType* data)
+        : data_(data)
+      {}
+
+      void write (const DataType& t)
+      {
+        *data_++ = t;
+      }
+
+      void read (DataType& t)
+      {
+        t = *data_++;
+      }
+
+    private:
+      DataType* data_;
+    };
+
+  public:
+    /** \brief Make an empty interface communicating over the given communicator */
+    explicit UGCommInterface (const shared_ptr<UGCommInterfaceCommunicator>& comm)
+      : comm_(comm)
+    {}
+
+    /** \brief Return true if the interface type can be set up here, otherwise the DDD interfaces are used */
+    static bool supported (InterfaceType iftype)
+    {
+      return iftype==InteriorBorder_InteriorBorder_Interface
+             || iftype==InteriorBorder_All_Interface
+             || iftype==All_All_Interface;
+    }
+
+    /** \brief Set up the interface for the entities of a grid view */
+    template <class GridView>
+    void build (const GridView& gv, InterfaceType iftype, CommunicationDirection dir)
+    {
+      MPI_Comm comm = comm_->get();
+      int rank, size;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+
+      // collect the candidates for sending and receiving per process
+      std::vector<std::vector<Candidate> > sendCandidates(size), recvCandidates(size);
+
+      typedef typename GridView::template Codim<codim>::template Partition<All_Partition>::Iterator Iterator;
+      const Iterator endIt = gv.template end<codim, All_Partition>();
+      for (Iterator it = gv.template begin<codim, All_Partition>(); it != endIt; ++it)
+      {
+        UGEntity* target = gv.grid().getRealImplementation(*it).getTarget();
+        typename UG_NS<dim>::DDD_HEADER* hdr = UG_NS<dim>::ParHdr(target);
+        const int myPrio = hdr->prio;
+        const int* plist = UG_NS<dim>::DDD_InfoProcList(hdr);
+        for (int i = 0; plist[i] >= 0; i += 2)
+        {
+          if (plist[i] == rank)
+            continue;
+          if (transfers(iftype, dir, myPrio, plist[i+1]))
+            sendCandidates[plist[i]].push_back(Candidate(hdr->gid, target));
+          if (transfers(iftype, dir, plist[i+1], myPrio))
+            recvCandidates[plist[i]].push_back(Candidate(hdr->gid, target));
+        }
+      }
+
+      // tell every process how many entities it may get from us
+      std::vector<int> sendCounts(size), recvCounts(size);
+      for (int p = 0; p < size; p++)
+      {
+        std::sort(sendCandidates[p].begin(), sendCandidates[p].end());
+        std::sort(recvCandidates[p].begin(), recvCandidates[p].end());
+        sendCounts[p] = sendCandidates[p].size();
+      }
+      MPI_Alltoall(&sendCounts[0], 1, MPI_INT, &recvCounts[0], 1, MPI_INT, comm);
+
+      // send the global ids of the candidates
+      std::vector<std::vector<GID> > sendGids(size);
+      std::vector<MPI_Request> requests;
+      for (int p = 0; p < size; p++)
+      {
+        if (sendCounts[p] == 0)
+          continue;
+        for (std::size_t i = 0; i < sendCandidates[p].size(); i++)
+          sendGids[p].push_back(sendCandidates[p][i].first);
+        requests.push_back(MPI_Request());
+        MPI_Isend(&sendGids[p][0], sendCounts[p]*sizeof(GID), MPI_BYTE, p, gidTag, comm, &requests.back());
+      }
+
+      // keep those entities which are on the receiving side of the interface here, too,
+      // and tell the sender which ones they are
+      recvRanks_.clear();
+      recvEntities_.clear();
+      std::vector<std::vector<int> > positions(size);
+      for (int p = 0; p < size; p++)
+      {
+        if (recvCounts[p] == 0)
+          continue;
+        std::vector<GID> gids(recvCounts[p]);
+        MPI_Recv(&gids[0], recvCounts[p]*sizeof(GID), MPI_BYTE, p, gidTag, comm, MPI_STATUS_IGNORE);
+
+        std::vector<UGEntity*> entities;
+        typename std::vector<Candidate>::const_iterator c = recvCandidates[p].begin();
+        for (int i = 0; i < recvCounts[p]; i++)
+        {
+          while (c != recvCandidates[p].end() && c->first < gids[i])
+            ++c;
+          if (c != recvCandidates[p].end() && c->first == gids[i])
+          {
+            positions[p].push_back(i);
+            entities.push_back(c->second);
+          }
+        }
+
+        requests.push_back(MPI_Request());
+        MPI_Isend(positions[p].empty() ? 0 : &positions[p][0], positions[p].size(), MPI_INT,
+                  p, positionTag, comm, &requests.back());
+
+        if (!entities.empty())
+        {
+          recvRanks_.push_back(p);
+          recvEntities_.push_back(entities);
+        }
+      }
+
+      // only send what the receiver needs
+      sendRanks_.clear();
+      sendEntities_.clear();
+      for (int p = 0; p < size; p++)
+      {
+        if (sendCounts[p] == 0)
+          continue;
+        MPI_Status status;
+        MPI_Probe(p, positionTag, comm, &status);
+        int count;
+        MPI_Get_count(&status, MPI_INT, &count);
+        std::vector<int> needed(count);
+        MPI_Recv(needed.empty() ? 0 : &needed[0], count, MPI_INT, p, positionTag, comm, MPI_STATUS_IGNORE);
+
+        if (needed.empty())
+          continue;
+        sendRanks_.push_back(p);
+        sendEntities_.push_back(std::vector<UGEntity*>(needed.size()));
+        for (std::size_t i = 0; i < needed.size(); i++)
+          sendEntities_.back()[i] = sendCandidates[p][needed[i]].second;
+      }
+
+      if (!requests.empty())
+        MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+    }
+
+    /** \brief Communicate the data of a data handle with fixed-size data over the interface */
+    template <class DataHandle, class GridImp>
+    void exchange (DataHandle& dataHandle, const GridImp* grid) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef UGMakeableEntity<codim, dim, GridImp> Entity;
+
+      MPI_Comm comm = comm_->get();
+      Entity entity;
+
+      std::vector<std::vector<DataType> > recvData(recvRanks_.size());
+      std::vector<MPI_Request> recvRequests(recvRanks_.size());
+      for (std::size_t i = 0; i < recvRanks_.size(); i++)
+      {
+        entity.setToTarget(recvEntities_[i][0], grid);
+        recvData[i].resize(recvEntities_[i].size() * dataHandle.size(entity));
+        MPI_Irecv(recvData[i].empty() ? 0 : &recvData[i][0], recvData[i].size()*sizeof(DataType), MPI_BYTE,
+                  recvRanks_[i], dataTag, comm, &recvRequests[i]);
+      }
+
+      std::vector<std::vector<DataType> > sendData(sendRanks_.size());
+      std::vector<MPI_Request> sendRequests(sendRanks_.size());
+      for (std::size_t i = 0; i < sendRanks_.size(); i++)
+      {
+        entity.setToTarget(sendEntities_[i][0], grid);
+        sendData[i].resize(sendEntities_[i].size() * dataHandle.size(entity));
+        Buffer<DataType> buffer(sendData[i].empty() ? 0 : &sendData[i][0]);
+        for (std::size_t j = 0; j < sendEntities_[i].size(); j++)
+        {
+          entity.setToTarget(sendEntities_[i][j], grid);
+          dataHandle.gather(buffer, entity);
+        }
+        MPI_Isend(sendData[i].empty() ? 0 : &sendData[i][0], sendData[i].size()*sizeof(DataType), MPI_BYTE,
+                  sendRanks_[i], dataTag, comm, &sendRequests[i]);
+      }
+
+      // unpack the messages in the order in which they arrive
+      for (std::size_t k = 0; k < recvRanks_.size(); k++)
+      {
+        int i;
+        MPI_Waitany(recvRequests.size(), &recvRequests[0], &i, MPI_STATUS_IGNORE);
+        Buffer<DataType> buffer(recvData[i].empty() ? 0 : &recvData[i][0]);
+        const std::size_t n = recvData[i].size() / recvEntities_[i].size();
+        for (std::size_t j = 0; j < recvEntities_[i].size(); j++)
+        {
+          entity.setToTarget(recvEntities_[i][j], grid);
+          dataHandle.scatter(buffer, entity, n);
+        }
+      }
+
+      if (!sendRequests.empty())
+        MPI_Waitall(sendRequests.size(), &sendRequests[0], MPI_STATUSES_IGNORE);
+    }
+
+  private:
+    //! Return true if the interface transfers data from an entity with priority from to a copy with priority to
+    static bool transfers (InterfaceType iftype, CommunicationDirection dir, int from, int to)
+    {
+      if (dir == BackwardCommunication)
+        std::swap(from, to);
+
+      switch (iftype)
+      {
+      case InteriorBorder_InteriorBorder_Interface :
+        return interiorBorder(from) && interiorBorder(to);
+      case InteriorBorder_All_Interface :
+        return interiorBorder(from);
+      case All_All_Interface :
+        return true;
+      default :
+        return false;
+      }
+    }
+
+    static bool interiorBorder (int prio)
+    {
+      return prio == UG_NS<dim>::PrioMaster
+             || prio == UG_NS<dim>::PrioBorder
+             || prio == UG_NS<dim>::PrioNone;
+    }
+
+    shared_ptr<UGCommInterfaceCommunicator> comm_;
+    std::vector<int> sendRanks_;
+    std::vector<std::vector<UGEntity*> > sendEntities_;
+    std::vector<int> recvRanks_;
+    std::vector<std::vector<UGEntity*> > recvEntities_;
+  };
+
+}   // end namespace Dune
+
+#endif  // UG_COMM_INTERFACE_HH
@@ -11,6 +11,8 @@
 #include <dune/common/sllist.hh>
 #include <dune/common/stdstreams.hh>
 
+#include <dune/grid/common/mcmgmapper.hh>
+
 
 using namespace Dune;
 
@@ -35,6 +37,9 @@ Dune::UGGrid < dim >::UGGrid()
     idSet_(*this),
     refinementType_(LOCAL),
     closureType_(GREEN),
+    incrementalLeafIndexUpdate_(false),
+    geometryCaching_(false),
+    geometryCacheIsOutdated_(true),
     someElementHasBeenMarkedForRefinement_(false),
     someElementHasBeenMarkedForCoarsening_(false),
     numBoundarySegments_(0)
@@ -545,6 +550,38 @@ bool Dune::UGGrid < dim >::loadBalance(int strategy, int minlevel, int depth, in
 }
 
 
+template < int dim >
+bool Dune::UGGrid < dim >::loadBalance(const std::vector<int>& targetProcessors, int fromLevel)
+{
+  // Do nothing if we are on a single process
+  if (comm().size()==1)
+    return true;
+
+#ifdef ModelP
+  // The leaf indices are per geometry type, the mapper makes them unique
+  const LeafMultipleCodimMultipleGeomTypeMapper<UGGrid<dim>, MCMGElementLayout> mapper(*this);
+  if (targetProcessors.size() != (std::size_t)mapper.size())
+    DUNE_THROW(GridError, "loadBalance: need one target processor per leaf element");
+
+  // Set the target processors of the leaf elements
+  typedef typename Traits::template Codim<0>::template Partition<Interior_Partition>::LeafIterator ElementIterator;
+  const ElementIterator eEndIt = this->template leafend<0,Interior_Partition>();
+  for (ElementIterator eIt = this->template leafbegin<0,Interior_Partition>(); eIt != eEndIt; ++eIt)
+    UG_NS<dim>::Partition(this->getRealImplementation(*eIt).getTarget())
+      = targetProcessors[mapper.map(*eIt)];
+
+  int errCode = UG_NS<dim>::TransferGridFromLevel(multigrid_, fromLevel);
+
+  if (errCode)
+    DUNE_THROW(GridError, "UG" << dim << "d::TransferGridFromLevel returned error code " << errCode);
+
+  // Renumber everything
+  setIndices(true, NULL);
+#endif
+
+  return true;
+}
+
 template < int dim >
 void Dune::UGGrid < dim >::setPosition(const typename Traits::template Codim<dim>::EntityPointer& e,
                                        const FieldVector<double, dim>& pos)
@@ -553,6 +590,8 @@ void Dune::UGGrid < dim >::setPosition(const typename Traits::template Codim<dim
 
   for (int i=0; i<dim; i++)
     target->myvertex->iv.x[i] = pos[i];
+
+  geometryCacheIsOutdated_ = true;
 }
 
 template <int dim>
@@ -708,7 +747,17 @@ void Dune::UGGrid < dim >::setIndices(bool setLevelZero,
     if (levelIndexSets_[i])
       levelIndexSets_[i]->update(*this, i);
 
-  leafIndexSet_.update(nodePermutation);
+  // The level 0 is only set anew if the whole grid has changed, e.g. by load balancing.
+  // After adaptation the leaf indices may be updated incrementally.
+  leafIndexSet_.update(nodePermutation, incrementalLeafIndexUpdate_ && !setLevelZero, incrementalLeafIndexUpdate_);
+
+#ifdef ModelP
+  // The communication interfaces have to be set up anew
+  commInterfaces_.clear();
+#endif
+
+  // The cached geometries are recomputed on the next access
+  geometryCacheIsOutdated_ = true;
 
   // id sets don't need updating
 }
@@ -196,7 +196,7 @@ void Dune::UGGridEntity < 0, dim ,GridImp >::
 setToTarget(typename UG_NS<dim>::Element* target, const GridImp* gridImp)
 {
   target_ = target;
-  geo_.setToTarget(target);
+  geo_.setToTarget(target, gridImp ? gridImp->geometryCacheEntry(target) : NULL);
   gridImp_ = gridImp;
 }
 
@@ -3,6 +3,8 @@
 
 #include <config.h>
 
+#include <algorithm>
+
 #include <dune/common/parallel/mpihelper.hh>
 
 #include <dune/grid/uggrid/uggridfactory.hh>
@@ -106,74 +108,107 @@ insertVertex(const Dune::FieldVector<typename Dune::GridFactory<Dune::UGGrid<dim
 
 template <int dimworld>
 void Dune::GridFactory<Dune::UGGrid<dimworld> >::
-insertElement(const GeometryType& type,
-              const std::vector<unsigned int>& vertices)
+insertVertices(const std::vector<ctype>& coordinates)
 {
-  if (dimworld!=type.dim())
-    DUNE_THROW(GridError, "You cannot insert a " << type
-                                                 << " into a UGGrid<" << dimworld << ">!");
-
-  int newIdx = elementVertices_.size();
+  if (coordinates.size() % dimworld != 0)
+    DUNE_THROW(GridError, "The number of coordinates (" << coordinates.size()
+                                                        << ") is not a multiple of " << dimworld << "!");
 
-  elementTypes_.push_back(vertices.size());
-  for (unsigned int i=0; i<vertices.size(); i++)
-    elementVertices_.push_back(vertices[i]);
+  const size_t oldSize = vertexPositions_.size();
+  vertexPositions_.resize(oldSize + coordinates.size()/dimworld);
 
-  if (type.isTriangle()) {
-    // Everything alright
-    if (vertices.size() != 3)
-      DUNE_THROW(GridError, "You have requested to enter a triangle, but you"
-                 << " have provided " << vertices.size() << " vertices!");
-
-  } else if (type.isQuadrilateral()) {
-
-    if (vertices.size() != 4)
-      DUNE_THROW(GridError, "You have requested to enter a quadrilateral, but you"
-                 << " have provided " << vertices.size() << " vertices!");
+  for (size_t i=0; i<coordinates.size()/dimworld; i++)
+    for (int j=0; j<dimworld; j++)
+      vertexPositions_[oldSize+i][j] = coordinates[i*dimworld+j];
+}
 
-    // DUNE and UG numberings differ --> reorder the vertices
-    elementVertices_[newIdx+2] = vertices[3];
-    elementVertices_[newIdx+3] = vertices[2];
+template <int dimworld>
+void Dune::GridFactory<Dune::UGGrid<dimworld> >::
+insertElement(const GeometryType& type,
+              const std::vector<unsigned int>& vertices)
+{
+  const unsigned int n = numCorners(type);
+  if (vertices.size() != n)
+    DUNE_THROW(GridError, "You have requested to enter a " << type << ", but you"
+               << " have provided " << vertices.size() << " vertices!");
 
-  } else if (type.isTetrahedron()) {
+  const size_t newIdx = elementVertices_.size();
 
-    if (vertices.size() != 4)
-      DUNE_THROW(GridError, "You have requested to enter a tetrahedron, but you"
-                 << " have provided " << vertices.size() << " vertices!");
+  elementTypes_.push_back(n);
+  elementVertices_.insert(elementVertices_.end(), vertices.begin(), vertices.end());
 
-  } else if (type.isPyramid()) {
+  renumberVertices(type, &elementVertices_[newIdx]);
+}
 
-    if (vertices.size() != 5)
-      DUNE_THROW(GridError, "You have requested to enter a pyramid, but you"
-                 << " have provided " << vertices.size() << " vertices!");
+template <int dimworld>
+void Dune::GridFactory<Dune::UGGrid<dimworld> >::
+insertElements(const GeometryType& type,
+               const std::vector<unsigned int>& vertices)
+{
+  const unsigned int n = numCorners(type);
+  if (vertices.size() % n != 0)
+    DUNE_THROW(GridError, "You have requested to enter elements of type " << type << ", but the"
+               << " number of vertices (" << vertices.size() << ") is not a multiple of " << n << "!");
 
-    // DUNE and UG numberings differ --> reorder the vertices
-    elementVertices_[newIdx+2] = vertices[3];
-    elementVertices_[newIdx+3] = vertices[2];
+  const size_t newIdx = elementVertices_.size();
 
-  } else if (type.isPrism()) {
+  elementTypes_.resize(elementTypes_.size() + vertices.size()/n, n);
+  elementVertices_.insert(elementVertices_.end(), vertices.begin(), vertices.end());
 
-    if (vertices.size() != 6)
-      DUNE_THROW(GridError, "You have requested to enter a prism, but you"
-                 << " have provided " << vertices.size() << " vertices!");
+  for (size_t i=newIdx; i<elementVertices_.size(); i+=n)
+    renumberVertices(type, &elementVertices_[i]);
+}
 
-  } else if (type.isHexahedron()) {
+template <int dimworld>
+unsigned int Dune::GridFactory<Dune::UGGrid<dimworld> >::
+numCorners(const GeometryType& type)
+{
+  if (dimworld==type.dim()) {
+    if (type.isTriangle())
+      return 3;
+    if (type.isQuadrilateral() || type.isTetrahedron())
+      return 4;
+    if (type.isPyramid())
+      return 5;
+    if (type.isPrism())
+      return 6;
+    if (type.isHexahedron())
+      return 8;
+  }
 
-    if (vertices.size() != 8)
-      DUNE_THROW(GridError, "You have requested to enter a hexahedron, but you"
-                 << " have provided " << vertices.size() << " vertices!");
+  DUNE_THROW(GridError, "You cannot insert a " << type
+                                               << " into a UGGrid<" << dimworld << ">!");
+}
 
-    // DUNE and UG numberings differ --> reorder the vertices
-    elementVertices_[newIdx+2] = vertices[3];
-    elementVertices_[newIdx+3] = vertices[2];
-    elementVertices_[newIdx+6] = vertices[7];
-    elementVertices_[newIdx+7] = vertices[6];
+template <int dimworld>
+void Dune::GridFactory<Dune::UGGrid<dimworld> >::
+renumberVertices(const GeometryType& type, unsigned int* vertices)
+{
+  // DUNE and UG numberings differ for cubes and pyramids --> reorder the vertices
+  if (type.isQuadrilateral() || type.isPyramid() || type.isHexahedron())
+    std::swap(vertices[2], vertices[3]);
 
-  } else {
-    DUNE_THROW(GridError, "You cannot insert a " << type
-                                                 << " into a UGGrid<" << dimworld << ">!");
-  }
+  if (type.isHexahedron())
+    std::swap(vertices[6], vertices[7]);
+}
 
+template <int dimworld>
+unsigned int Dune::GridFactory<Dune::UGGrid<dimworld> >::
+heapSize() const
+{
+  // Rough upper bounds for the memory UG needs per coarse grid vertex and element,
+  // including the edges, sides and vectors created along with them
+  const double bytesPerVertex  = (dimworld==2) ? 256 : 512;
+  const double bytesPerElement = (dimworld==2) ? 512 : 2048;
+
+  // The coarse grid is only built on rank 0.  The other processes get their
+  // share of it by load balancing later, so they only need room for that share.
+  const CollectiveCommunication<MPIHelper::MPICommunicator>& comm = MPIHelper::getCollectiveCommunication();
+  const double localPart = (comm.rank()==0) ? 1.0 : 1.0/comm.size();
+  const double required = localPart * (bytesPerVertex*vertexPositions_.size() + bytesPerElement*elementTypes_.size());
+  const unsigned int requiredMegabytes = static_cast<unsigned int>(required/(1024*1024)) + 1;
+
+  return std::max(grid_->heapSize_, requiredMegabytes);
 }
 
 template <int dimworld>
@@ -460,7 +495,7 @@ createGrid()
 
   sprintf(newArgs[1], "b %s_Problem", grid_->name_.c_str());
   sprintf(newArgs[2], "f DuneFormat%dd", dimworld);
-  sprintf(newArgs[3], "h %dM", grid_->heapSize_);
+  sprintf(newArgs[3], "h %dM", heapSize());
 
   if (UG_NS<dimworld>::NewCommand(4, newArgs))
     DUNE_THROW(GridError, "UGGrid<" << dimworld << ">::makeNewMultigrid failed!");
@@ -529,7 +564,7 @@ createGrid()
   int idx = 0;
   for (size_t i=0; i<elementTypes_.size(); i++) {
 
-    const typename UG_NS<dimworld>::Node* vertices[elementTypes_[i]];
+    const typename UG_NS<dimworld>::Node* vertices[8];
     for (size_t j=0; j<elementTypes_[i]; j++)
       vertices[j] = nodePointers[isBoundaryNode[elementVertices_[idx++]]];
 
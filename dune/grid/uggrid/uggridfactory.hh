@@ -87,6 +87,21 @@ namespace Dune {
      The numbering of the vertices of each element is expected to follow the DUNE conventions.
      Refer to the page on reference elements for the details.
 
+    <p>
+    Large coarse grids can also be entered in bulk, with flat arrays of vertex
+    coordinates and element vertices, by calling
+    </p>
+
+    <pre>
+    factory.insertVertices(const std::vector&lt;double&gt;& coordinates);
+    factory.insertElements(Dune::GeometryType type, const std::vector&lt;unsigned int&gt;& vertices);
+    </pre>
+
+    <p>
+    once per element type.  The result is the same as inserting the vertices and
+    elements one by one in the order of the arrays.
+    </p>
+
      <h2> 4) Parametrized Domains </h2>
 
      <p>
@@ -194,6 +209,25 @@ namespace Dune {
     virtual void insertElement(const GeometryType& type,
                                const std::vector<unsigned int>& vertices);
 
+    /** \brief Insert many vertices into the coarse grid at once
+        \param coordinates The coordinates of the new vertices, dimworld consecutive entries per vertex
+
+       The vertices get the insertion indices following the ones inserted so far,
+       in the order in which they appear in the array.
+     */
+    void insertVertices(const std::vector<ctype>& coordinates);
+
+    /** \brief Insert many elements of the same type into the coarse grid at once
+        \param type The GeometryType of the new elements
+        \param vertices The vertices of the new elements, using the DUNE numbering.
+        The vertices of each element are consecutive entries of the array.
+
+       This is equivalent to calling insertElement() for each element, but the
+       connectivity is copied in one go without temporary arrays per element.
+     */
+    void insertElements(const GeometryType& type,
+                        const std::vector<unsigned int>& vertices);
+
     /** \brief Method to insert a boundary segment into a coarse grid
 
        Using this method is optional.  It only influences the ordering of the segments
@@ -249,6 +283,15 @@ namespace Dune {
     // Initialize the grid structure in UG
     void createBegin();
 
+    // Check that the element type can be inserted and return its number of vertices
+    static unsigned int numCorners(const GeometryType& type);
+
+    // Reorder the vertices of an element from the DUNE to the UG numbering
+    static void renumberVertices(const GeometryType& type, unsigned int* vertices);
+
+    // The heap size in megabytes to use for the coarse grid
+    unsigned int heapSize() const;
+
     // Pointer to the grid being built
     UGGrid<dimworld>* grid_;
 
@@ -72,6 +72,9 @@ corner(int i) const
   // ////////////////////////////////
   assert(mydim==coorddim);
 
+  if (cache_)
+    return cache_->corner[i];
+
   i = UGGridRenumberer<mydim>::verticesDUNEtoUG(i,type());
 
   Dune::FieldVector<typename GridImp::ctype, coorddim> result;
@@ -87,6 +90,12 @@ global(const FieldVector<UGCtype, mydim>& local) const
 {
   FieldVector<UGCtype, coorddim> globalCoord(0.0);
 
+  if (cache_ && cache_->affine) {
+    globalCoord = cache_->corner[0];
+    cache_->jacobianTransposed.umtv(local, globalCoord);
+    return globalCoord;
+  }
+
   // we are an actual element in UG
   UGCtype* cornerCoords[corners()];
   UG_NS<coorddim>::Corner_Coordinates(target_, cornerCoords);
@@ -110,6 +119,13 @@ local (const Dune::FieldVector<typename GridImp::ctype, coorddim>& global) const
   if (mydim==0)
     return result;
 
+  if (cache_ && cache_->affine) {
+    FieldVector<UGCtype, coorddim> diff = global;
+    diff -= cache_->corner[0];
+    cache_->jacobianInverseTransposed.mtv(diff, result);
+    return result;
+  }
+
   // coorddim*coorddim is an upper bound for the number of vertices
   UGCtype* cornerCoords[coorddim*coorddim];
   UG_NS<coorddim>::Corner_Coordinates(target_, cornerCoords);
@@ -128,6 +144,8 @@ integrationElement (const Dune::FieldVector<typename GridImp::ctype, mydim>& loc
 {
   if (mydim==0)
     return 1;
+  else if (cache_ && cache_->affine)
+    return cache_->integrationElement;
   else
     /** \todo No need to recompute the determinant every time on a simplex */
     return std::abs(1/jacobianInverseTransposed(local).determinant());
@@ -141,6 +159,15 @@ jacobianInverseTransposed (const Dune::FieldVector<typename GridImp::ctype, mydi
   if (jacobianInverseIsUpToDate_)
     return jac_inverse_;
 
+  if (cache_ && cache_->affine) {
+    // element-wise, because the matrix sizes only match for mydim==coorddim
+    for (int i=0; i<coorddim; i++)
+      for (int j=0; j<mydim; j++)
+        jac_inverse_[i][j] = cache_->jacobianInverseTransposed[i][j];
+    jacobianInverseIsUpToDate_ = true;
+    return jac_inverse_;
+  }
+
   // compile array of pointers to corner coordinates
   UGCtype* cornerCoords[corners()];
   UG_NS<coorddim>::Corner_Coordinates(target_, cornerCoords);
@@ -160,6 +187,14 @@ jacobianTransposed (const Dune::FieldVector<typename GridImp::ctype, mydim>& loc
   if (jacobianIsUpToDate_)
     return jac_;
 
+  if (cache_ && cache_->affine) {
+    for (int i=0; i<mydim; i++)
+      for (int j=0; j<coorddim; j++)
+        jac_[i][j] = cache_->jacobianTransposed[i][j];
+    jacobianIsUpToDate_ = true;
+    return jac_;
+  }
+
   // compile array of pointers to corner coordinates
   UGCtype* cornerCoords[corners()];
   UG_NS<coorddim>::Corner_Coordinates(target_, cornerCoords);
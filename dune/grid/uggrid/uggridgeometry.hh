@@ -11,6 +11,8 @@
 
 #include <dune/geometry/multilineargeometry.hh>
 
+#include <dune/grid/uggrid/uggridgeometrycache.hh>
+
 namespace Dune {
 
 
@@ -37,6 +39,7 @@ namespace Dune {
     /** \brief Default constructor
      */
     UGGridGeometry()
+      : cache_(NULL)
     {
       jacobianIsUpToDate_ = false;
       jacobianInverseIsUpToDate_ = false;
@@ -49,12 +52,12 @@ namespace Dune {
      */
     GeometryType type () const;
 
-    //! returns true if type is simplex, false otherwise
-    bool affine() const { return type().isSimplex(); }
+    //! returns true if type is simplex or, if the geometry is cached, an affine cube
+    bool affine() const { return cache_ ? cache_->affine : type().isSimplex(); }
 
     //! return the number of corners of this element.
     int corners () const {
-      return UG_NS<coorddim>::Corners_Of_Elem(target_);
+      return cache_ ? cache_->corners : UG_NS<coorddim>::Corners_Of_Elem(target_);
     }
 
     //! access to coordinates of corners. Index is the number of the corner
@@ -95,6 +98,9 @@ namespace Dune {
       if (mydim==0)
         return 1;
 
+      if (cache_)
+        return cache_->volume;
+
       // coorddim*coorddim is an upper bound for the number of vertices
       UGCtype* cornerCoords[coorddim*coorddim];
       UG_NS<coorddim>::Corner_Coordinates(target_, cornerCoords);
@@ -110,10 +116,14 @@ namespace Dune {
 
   private:
 
-    /** \brief Init the element with a given UG element */
-    void setToTarget(typename UG_NS<coorddim>::template Entity<coorddim-mydim>::T* target)
+    /** \brief Init the element with a given UG element
+        \param cache The cached geometry data of the element, or NULL to compute everything from the UG data
+     */
+    void setToTarget(typename UG_NS<coorddim>::template Entity<coorddim-mydim>::T* target,
+                     const UGGridGeometryCacheEntry<coorddim>* cache = NULL)
     {
       target_ = target;
+      cache_ = cache;
       jacobianIsUpToDate_ = false;
       jacobianInverseIsUpToDate_ = false;
     }
@@ -133,6 +143,9 @@ namespace Dune {
     // in coord_mode this is the element whose reference element is mapped into the father's one
     typename UG_NS<coorddim>::template Entity<coorddim-mydim>::T* target_;
 
+    //! The cached data of a leaf element, see UGGrid::setGeometryCaching()
+    const UGGridGeometryCacheEntry<coorddim>* cache_;
+
   };
 
 
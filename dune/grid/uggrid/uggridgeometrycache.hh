@@ -0,0 +1,172 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_UGGRIDGEOMETRYCACHE_HH
+#define DUNE_UGGRIDGEOMETRYCACHE_HH
+
+/** \file
+ * \brief The geometry cache of the UGGrid leaf elements
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/type.hh>
+
+namespace Dune {
+
+  /** \brief The cached geometry data of one leaf element of a UGGrid
+   * \ingroup UGGrid
+   */
+  template <int dim>
+  struct UGGridGeometryCacheEntry
+  {
+    //! The number of corners, zero if nothing has been cached
+    int corners;
+
+    //! True if the map from the reference element is affine
+    bool affine;
+
+    //! The corners, in DUNE numbering
+    FieldVector<double,dim> corner[1<<dim];
+
+    //! The transposed Jacobian of the map, only set if it is affine
+    FieldMatrix<double,dim,dim> jacobianTransposed;
+
+    //! The inverse transposed Jacobian of the map, only set if it is affine
+    FieldMatrix<double,dim,dim> jacobianInverseTransposed;
+
+    //! The integration element, only set if the map is affine
+    double integrationElement;
+
+    //! The volume of the element
+    double volume;
+  };
+
+  /** \brief Geometry data of all leaf elements of a UGGrid
+   * \ingroup UGGrid
+
+     The data is computed once for all leaf elements after the grid has changed.
+     The UGGridGeometry objects of leaf elements then take the corners, the volume,
+     and, for affine elements, the Jacobians from here instead of recomputing them
+     from the UG data.  Simplices and parallelograms/parallelepipeds are affine.
+
+     The leaf index set numbers the elements of each geometry type separately, so
+     the entries are stored by geometry type, and within each type by leaf index.
+     The geometry type is told apart by the number of corners, which is unique
+     among the element types of a UGGrid.
+   */
+  template <int dim>
+  class UGGridGeometryCache
+  {
+  public:
+    typedef UGGridGeometryCacheEntry<dim> Entry;
+
+    //! Remove all cached data
+    void clear ()
+    {
+      entries_.clear();
+      offset_.clear();
+    }
+
+    //! Recompute the data of all leaf elements of a grid
+    template <class GridImp>
+    void update (const GridImp& grid)
+    {
+      typedef typename GridImp::template Codim<0>::LeafIterator Iterator;
+      typedef typename GridImp::template Codim<0>::Geometry Geometry;
+
+      // The entries of each geometry type start behind the ones of the previous types
+      const std::vector<GeometryType>& types = grid.leafIndexSet().geomTypes(0);
+      offset_.assign(maxCorners+1, -1);
+      int size = 0;
+      for (std::size_t i=0; i<types.size(); i++)
+      {
+        offset_[ReferenceElements<double,dim>::general(types[i]).size(dim)] = size;
+        size += grid.leafIndexSet().size(types[i]);
+      }
+
+      // Mark everything as not cached, so the geometries below are computed from the UG data
+      entries_.resize(size);
+      for (std::size_t i=0; i<entries_.size(); i++)
+        entries_[i].corners = 0;
+
+      // Fill a separate array, the one above has to stay empty during the loop
+      std::vector<Entry> entries(entries_.size());
+
+      const Iterator endIt = grid.template leafend<0>();
+      for (Iterator it = grid.template leafbegin<0>(); it != endIt; ++it)
+      {
+        const Geometry geometry = it->geometry();
+        Entry& entry = entries[offset_[geometry.corners()] + grid.leafIndexSet().index(*it)];
+
+        entry.corners = geometry.corners();
+        for (int i=0; i<entry.corners; i++)
+          entry.corner[i] = geometry.corner(i);
+        entry.volume = geometry.volume();
+
+        // The columns of the Jacobian are the edges from corner 0 to the
+        // corners which are the images of the unit vectors
+        const bool simplex = it->type().isSimplex();
+        entry.affine = simplex || (it->type().isCube() && isParallelepiped(entry));
+        if (entry.affine)
+        {
+          for (int i=0; i<dim; i++)
+            entry.jacobianTransposed[i] = entry.corner[simplex ? i+1 : 1<<i] - entry.corner[0];
+          entry.jacobianInverseTransposed = entry.jacobianTransposed;
+          entry.jacobianInverseTransposed.invert();
+          entry.integrationElement = std::abs(entry.jacobianTransposed.determinant());
+        }
+      }
+
+      entries_.swap(entries);
+    }
+
+    /** \brief The cached data of a leaf element with the given number of corners and leaf index, or NULL if there is none */
+    const Entry* entry (int corners, int leafIndex) const
+    {
+      if (corners < 0 || corners >= int(offset_.size()) || offset_[corners] < 0 || leafIndex < 0)
+        return NULL;
+      const std::size_t i = offset_[corners] + leafIndex;
+      if (i >= entries_.size() || entries_[i].corners != corners)
+        return NULL;
+      return &entries_[i];
+    }
+
+  private:
+    //! Return true if the corners of a cube are the corners of a parallelogram or parallelepiped
+    static bool isParallelepiped (const Entry& entry)
+    {
+      double scale = 0;
+      for (int i=1; i<entry.corners; i++)
+        scale = std::max(scale, (entry.corner[i] - entry.corner[0]).infinity_norm());
+
+      for (int k=3; k<entry.corners; k++)
+      {
+        // a corner with more than one bit set has to be the sum of the edges for its bits
+        FieldVector<double,dim> c = entry.corner[0];
+        for (int i=0; i<dim; i++)
+          if (k & (1<<i))
+            c += entry.corner[1<<i] - entry.corner[0];
+        if ((c - entry.corner[k]).infinity_norm() > 1e-12*scale)
+          return false;
+      }
+      return true;
+    }
+
+    //! the largest number of corners of an element
+    enum { maxCorners = 1<<dim };
+
+    std::vector<Entry> entries_;
+
+    //! the position of the first entry of the elements with a given number of corners, -1 if there are none
+    std::vector<int> offset_;
+  };
+
+}  // namespace Dune
+
+#endif
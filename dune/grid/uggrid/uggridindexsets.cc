@@ -155,7 +155,20 @@ void Dune::UGGridLevelIndexSet<GridImp>::update(const GridImp& grid, int level,
 }
 
 template <class GridImp>
-void Dune::UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutation) {
+void Dune::UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutation, bool incremental, bool recordKeys) {
+
+  if (incremental) {
+    updateIncrementally();
+    return;
+  }
+
+  // Forget the old keys, the new ones are recorded after numbering if requested
+  for (int i=0; i<4; i++)
+    elementNumbering_[i].clear();
+  vertexNumbering_.clear();
+  edgeNumbering_.clear();
+  faceNumbering_[0].clear();
+  faceNumbering_[1].clear();
 
   // //////////////////////////////////////////////////////
   // Handle codim 1 and dim-1: levelwise from top to bottom
@@ -381,6 +394,341 @@ void Dune::UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePe
   myTypes_[dim].resize(0);
   myTypes_[dim].push_back(GeometryType(0));
 
+  if (recordKeys)
+    recordLeafKeys();
+}
+
+template <class GridImp>
+void Dune::UGGridLeafIndexSet<GridImp>::recordLeafKeys()
+{
+  typedef UGGridLeafNumbering::Key Key;
+
+  // Same order and keys as in updateIncrementally(), so that the first key
+  // recorded for an index is the one found there first
+  for (int level_=grid_.maxLevel(); level_>=0; level_--)
+  {
+    typename GridImp::Traits::template Codim<0>::LevelIterator eIt    = grid_.template lbegin<0>(level_);
+    typename GridImp::Traits::template Codim<0>::LevelIterator eEndIt = grid_.template lend<0>(level_);
+
+    for (; eIt!=eEndIt; ++eIt)
+    {
+      if (!eIt->isLeaf())
+        continue;
+
+      typename UG_NS<dim>::Element* target_ = grid_.getRealImplementation(*eIt).target_;
+      const GeometryType gt = eIt->type();
+      const ReferenceElement<double,dim>& refElement = ReferenceElements<double,dim>::general(gt);
+
+      numbering(gt).assign(UG_NS<dim>::leafIndex(target_), Key(UG_NS<dim>::id(target_)));
+
+      for (int i=0; i<eIt->template count<dim-1>(); i++)
+      {
+        const int a = UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,dim-1,0,dim),gt);
+        const int b = UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,dim-1,1,dim),gt);
+        const unsigned int cornerIds[2] = {UG_NS<dim>::id(UG_NS<dim>::Corner(target_,a)),
+                                           UG_NS<dim>::id(UG_NS<dim>::Corner(target_,b))};
+        edgeNumbering_.assign(UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(target_,a),
+                                                                        UG_NS<dim>::Corner(target_,b))),
+                              Key(cornerIds, cornerIds+2));
+      }
+
+      if (dim==3)
+        for (int i=0; i<eIt->template count<1>(); i++)
+        {
+          const int side = UGGridRenumberer<dim>::facesDUNEtoUG(i,gt);
+          unsigned int cornerIds[4];
+          const int nCorners = refElement.size(i,1,dim);
+          for (int j=0; j<nCorners; j++)
+            cornerIds[j] = UG_NS<dim>::id(UG_NS<dim>::Corner(target_,
+                                                             UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,1,j,dim),gt)));
+          faceNumbering_[refElement.type(i,1).isSimplex() ? 0 : 1].assign(UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(target_,side)),
+                                                                           Key(cornerIds, cornerIds+nCorners));
+        }
+    }
+  }
+
+  typename GridImp::Traits::template Codim<dim>::LeafIterator vIt    = grid_.template leafbegin<dim>();
+  typename GridImp::Traits::template Codim<dim>::LeafIterator vEndIt = grid_.template leafend<dim>();
+  for (; vIt!=vEndIt; ++vIt)
+  {
+    typename UG_NS<dim>::Node* node = grid_.getRealImplementation(*vIt).target_;
+    vertexNumbering_.assign(UG_NS<dim>::leafIndex(node), Key(UG_NS<dim>::id(node)));
+  }
+}
+
+template <class GridImp>
+void Dune::UGGridLeafIndexSet<GridImp>::updateIncrementally()
+{
+  typedef UGGridLeafNumbering::Key Key;
+
+  for (int i=0; i<4; i++)
+    elementNumbering_[i].begin();
+  vertexNumbering_.begin();
+  edgeNumbering_.begin();
+  faceNumbering_[0].begin();
+  faceNumbering_[1].begin();
+
+  // reset the isLeaf information of the nodes
+  for (int level_=grid_.maxLevel(); level_>=0; level_--)
+  {
+    typename GridImp::Traits::template Codim<0>::LevelIterator eIt    = grid_.template lbegin<0>(level_);
+    typename GridImp::Traits::template Codim<0>::LevelIterator eEndIt = grid_.template lend<0>(level_);
+
+    for (; eIt!=eEndIt; ++eIt)
+    {
+      typename UG_NS<dim>::Element* target_ = grid_.getRealImplementation(*eIt).target_;
+      for (int i=0; i<eIt->template count<dim>(); i++)
+        UG_NS<dim>::Corner(target_,i)->isLeaf = false;
+    }
+  }
+
+  // ////////////////////////////////////////////////////////////////
+  //   Keep the indices which are still valid and append new entities.
+  //   Levelwise from top to bottom, because the indices of edges and
+  //   faces are written through to the copies on coarser levels.
+  // ////////////////////////////////////////////////////////////////
+
+  for (int level_=grid_.maxLevel(); level_>=0; level_--)
+  {
+    // used to compute the coarsest level with leaf elements
+    bool containsLeafElements = false;
+
+    // this value is used in the parallel case, when a local grid may not contain any elements at all
+    coarsestLevelWithLeafElements_ = 0;
+
+    typename GridImp::Traits::template Codim<0>::LevelIterator eIt    = grid_.template lbegin<0>(level_);
+    typename GridImp::Traits::template Codim<0>::LevelIterator eEndIt = grid_.template lend<0>(level_);
+
+    for (; eIt!=eEndIt; ++eIt)
+    {
+      // we need only look at leaf elements
+      if (!eIt->isLeaf())
+        continue;
+      else
+        containsLeafElements = true;
+
+      typename UG_NS<dim>::Element* target_ = grid_.getRealImplementation(*eIt).target_;
+      const GeometryType gt = eIt->type();
+      const ReferenceElement<double,dim>& refElement = ReferenceElements<double,dim>::general(gt);
+
+      // codim 0: a copy of a former leaf element takes over the index of its father
+      {
+        UGGridLeafNumbering& elementNumbering = numbering(gt);
+        int& index = UG_NS<dim>::leafIndex(target_);
+        const Key key(UG_NS<dim>::id(target_));
+        if (!elementNumbering.keep(index, key))
+        {
+          typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
+          if (father_!=0 && UG_NS<dim>::hasCopy(father_)
+              && elementNumbering.keep(UG_NS<dim>::leafIndex(father_), Key(UG_NS<dim>::id(father_))))
+          {
+            index = UG_NS<dim>::leafIndex(father_);
+            elementNumbering.rename(index, key);
+          }
+          else
+            index = elementNumbering.insert(key);
+        }
+      }
+
+      // codim dim-1 (edges)
+      for (int i=0; i<eIt->template count<dim-1>(); i++)
+      {
+        const int a = UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,dim-1,0,dim),gt);
+        const int b = UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,dim-1,1,dim),gt);
+        int& index = UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(target_,a),
+                                                               UG_NS<dim>::Corner(target_,b)));
+        const unsigned int cornerIds[2] = {UG_NS<dim>::id(UG_NS<dim>::Corner(target_,a)),
+                                           UG_NS<dim>::id(UG_NS<dim>::Corner(target_,b))};
+        const Key key(cornerIds, cornerIds+2);
+        if (edgeNumbering_.keep(index, key))
+          continue;
+
+        // look for the index on the copies on coarser grids
+        typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
+        for (; father_!=0 && UG_NS<dim>::hasCopy(father_); father_ = UG_NS<dim>::EFather(father_))
+        {
+          const int fatherIndex = UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(father_,a),
+                                                                            UG_NS<dim>::Corner(father_,b)));
+          if (edgeNumbering_.keep(fatherIndex, key)) {
+            index = fatherIndex;
+            break;
+          }
+        }
+        if (father_!=0 && UG_NS<dim>::hasCopy(father_))
+          continue;
+
+        // a new edge: get new index and write it through to coarser grids
+        index = edgeNumbering_.insert(key);
+        for (father_ = UG_NS<dim>::EFather(target_); father_!=0 && UG_NS<dim>::hasCopy(father_); father_ = UG_NS<dim>::EFather(father_))
+          UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(father_,a),
+                                                    UG_NS<dim>::Corner(father_,b))) = index;
+      }
+
+      // codim 1 (faces)
+      if (dim==3)
+        for (int i=0; i<eIt->template count<1>(); i++)
+        {
+          const int side = UGGridRenumberer<dim>::facesDUNEtoUG(i,gt);
+          UG::UINT& index = UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(target_,side));
+
+          const GeometryType faceType = refElement.type(i,1);
+          if (!faceType.isSimplex() && !faceType.isCube())
+            DUNE_THROW(GridError, "wrong geometry type in face");
+          UGGridLeafNumbering& faceNumbering = faceNumbering_[faceType.isSimplex() ? 0 : 1];
+
+          unsigned int cornerIds[4];
+          const int nCorners = refElement.size(i,1,dim);
+          for (int j=0; j<nCorners; j++)
+            cornerIds[j] = UG_NS<dim>::id(UG_NS<dim>::Corner(target_,
+                                                             UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,1,j,dim),gt)));
+          const Key key(cornerIds, cornerIds+nCorners);
+          if (faceNumbering.keep(index, key))
+            continue;
+
+          // look for the index on the copies on coarser grids
+          typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
+          for (; father_!=0 && UG_NS<dim>::hasCopy(father_); father_ = UG_NS<dim>::EFather(father_))
+          {
+            const UG::UINT fatherIndex = UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(father_,side));
+            if (faceNumbering.keep(fatherIndex, key)) {
+              index = fatherIndex;
+              break;
+            }
+          }
+          if (father_!=0 && UG_NS<dim>::hasCopy(father_))
+            continue;
+
+          // a new face: get new index and write it through to coarser grids
+          index = faceNumbering.insert(key);
+          for (father_ = UG_NS<dim>::EFather(target_); father_!=0 && UG_NS<dim>::hasCopy(father_); father_ = UG_NS<dim>::EFather(father_))
+            UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(father_,side)) = index;
+        }
+
+      // set the isLeaf information of the nodes based on the leaf elements
+      for (int i=0; i<eIt->template count<dim>(); i++)
+        UG_NS<dim>::Corner(target_,i)->isLeaf = true;
+    }
+
+    if (containsLeafElements)
+      coarsestLevelWithLeafElements_ = level_;
+  }
+
+  // vertices: the leaf index is stored in the UG vertex, which is shared by all levels
+  typename GridImp::Traits::template Codim<dim>::LeafIterator vIt    = grid_.template leafbegin<dim>();
+  typename GridImp::Traits::template Codim<dim>::LeafIterator vEndIt = grid_.template leafend<dim>();
+
+  for (; vIt!=vEndIt; ++vIt)
+  {
+    typename UG_NS<dim>::Node* node = grid_.getRealImplementation(*vIt).target_;
+    int& index = UG_NS<dim>::leafIndex(node);
+    const Key key(UG_NS<dim>::id(node));
+    if (!vertexNumbering_.keep(index, key))
+      index = vertexNumbering_.insert(key);
+  }
+
+  // ////////////////////////////////////////////////////////////////
+  //   Close the holes.  Only the entities whose index was larger than
+  //   the new number of entities get a new index.
+  // ////////////////////////////////////////////////////////////////
+
+  bool moved = false;
+  for (int i=0; i<4; i++)
+    moved |= elementNumbering_[i].finish();
+  moved |= edgeNumbering_.finish();
+  moved |= faceNumbering_[0].finish();
+  moved |= faceNumbering_[1].finish();
+
+  if (moved)
+  {
+    for (int level_=grid_.maxLevel(); level_>=int(coarsestLevelWithLeafElements_); level_--)
+    {
+      typename GridImp::Traits::template Codim<0>::LevelIterator eIt    = grid_.template lbegin<0>(level_);
+      typename GridImp::Traits::template Codim<0>::LevelIterator eEndIt = grid_.template lend<0>(level_);
+
+      for (; eIt!=eEndIt; ++eIt)
+      {
+        if (!eIt->isLeaf())
+          continue;
+
+        typename UG_NS<dim>::Element* target_ = grid_.getRealImplementation(*eIt).target_;
+        const GeometryType gt = eIt->type();
+        const ReferenceElement<double,dim>& refElement = ReferenceElements<double,dim>::general(gt);
+
+        int& elementIndex = UG_NS<dim>::leafIndex(target_);
+        elementIndex = numbering(gt).newIndex(elementIndex);
+
+        for (int i=0; i<eIt->template count<dim-1>(); i++)
+        {
+          const int a = UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,dim-1,0,dim),gt);
+          const int b = UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,dim-1,1,dim),gt);
+          int& index = UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(target_,a),
+                                                                 UG_NS<dim>::Corner(target_,b)));
+          if (index < edgeNumbering_.size())
+            continue;
+          index = edgeNumbering_.newIndex(index);
+          for (typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
+               father_!=0 && UG_NS<dim>::hasCopy(father_); father_ = UG_NS<dim>::EFather(father_))
+            UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(father_,a),
+                                                      UG_NS<dim>::Corner(father_,b))) = index;
+        }
+
+        if (dim==3)
+          for (int i=0; i<eIt->template count<1>(); i++)
+          {
+            const int side = UGGridRenumberer<dim>::facesDUNEtoUG(i,gt);
+            UG::UINT& index = UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(target_,side));
+            const UGGridLeafNumbering& faceNumbering = faceNumbering_[refElement.type(i,1).isSimplex() ? 0 : 1];
+            if (index < UG::UINT(faceNumbering.size()))
+              continue;
+            index = faceNumbering.newIndex(index);
+            for (typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
+                 father_!=0 && UG_NS<dim>::hasCopy(father_); father_ = UG_NS<dim>::EFather(father_))
+              UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(father_,side)) = index;
+          }
+      }
+    }
+  }
+
+  if (vertexNumbering_.finish())
+    for (vIt = grid_.template leafbegin<dim>(); vIt!=vEndIt; ++vIt)
+    {
+      int& index = UG_NS<dim>::leafIndex(grid_.getRealImplementation(*vIt).target_);
+      index = vertexNumbering_.newIndex(index);
+    }
+
+  // Update the sizes and the lists of geometry types present
+  numSimplices_ = elementNumbering_[0].size();
+  numPyramids_  = elementNumbering_[1].size();
+  numPrisms_    = elementNumbering_[2].size();
+  numCubes_     = elementNumbering_[3].size();
+  numVertices_  = vertexNumbering_.size();
+  numEdges_     = edgeNumbering_.size();
+  numTriFaces_  = faceNumbering_[0].size();
+  numQuadFaces_ = faceNumbering_[1].size();
+
+  myTypes_[0].resize(0);
+  if (numSimplices_ > 0)
+    myTypes_[0].push_back(GeometryType(GeometryType::simplex,dim));
+  if (numPyramids_ > 0)
+    myTypes_[0].push_back(GeometryType(GeometryType::pyramid,dim));
+  if (numPrisms_ > 0)
+    myTypes_[0].push_back(GeometryType(GeometryType::prism,dim));
+  if (numCubes_ > 0)
+    myTypes_[0].push_back(GeometryType(GeometryType::cube,dim));
+
+  myTypes_[dim-1].resize(0);
+  myTypes_[dim-1].push_back(GeometryType(GeometryType::cube,1));
+
+  if (dim==3) {
+    myTypes_[1].resize(0);
+    if (numTriFaces_ > 0)
+      myTypes_[1].push_back(GeometryType(GeometryType::simplex,dim-1));
+    if (numQuadFaces_ > 0)
+      myTypes_[1].push_back(GeometryType(GeometryType::cube,dim-1));
+  }
+
+  myTypes_[dim].resize(0);
+  myTypes_[dim].push_back(GeometryType(0));
 }
 
 // Explicit template instantiations to compile the stuff in this file
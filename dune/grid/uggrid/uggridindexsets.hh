@@ -7,6 +7,7 @@
     \brief The index and id sets for the UGGrid class
  */
 
+#include <algorithm>
 #include <vector>
 #include <set>
 
@@ -167,6 +168,168 @@ namespace Dune {
     std::vector<GeometryType> myTypes_[dim+1];
   };
 
+  /** \brief Bookkeeping for the incremental update of the leaf indices of one geometry type
+
+     For each index the key of the entity owning it is stored.  An index found
+     in a UG object is still valid if it is owned by the key of that object, so
+     indices that are left over in UG objects from earlier grid states are never
+     mistaken for current ones.  The keys are built from the UG ids, which are
+     never reused.
+
+     An update calls begin(), then keep() or insert() for each leaf entity, and
+     finally finish(), which moves the entities with the largest indices into the
+     holes left by vanished entities.  The UG objects holding moved indices then
+     have to be set to newIndex().
+     A full update numbers the entities without this class and records the
+     keys with assign() afterwards, so the next update can be incremental.
+   */
+  class UGGridLeafNumbering
+  {
+  public:
+    UGGridLeafNumbering ()
+      : oldSize_(0)
+    {}
+
+    //! The key of an entity: its UG id, or the sorted ids of the corners
+    struct Key
+    {
+      Key ()
+      {
+        std::fill(v, v+4, ~0u);
+      }
+
+      explicit Key (unsigned int id)
+      {
+        std::fill(v, v+4, ~0u);
+        v[0] = id;
+      }
+
+      //! Key from the ids of at most four corners
+      template <class It>
+      Key (It begin, It end)
+      {
+        std::fill(v, v+4, ~0u);
+        std::copy(begin, end, v);
+        std::sort(v, v+4);
+      }
+
+      bool operator== (const Key& other) const
+      {
+        return std::equal(v, v+4, other.v);
+      }
+
+      unsigned int v[4];
+    };
+
+    //! Start an update
+    void begin ()
+    {
+      oldSize_ = owner_.size();
+      used_.assign(oldSize_, false);
+      remap_.clear();
+    }
+
+    //! Forget all indices, the next update numbers all entities anew
+    void clear ()
+    {
+      owner_.clear();
+      used_.clear();
+      remap_.clear();
+      indexMap_.clear();
+      oldSize_ = 0;
+    }
+
+    //! Return true if index belongs to the entity with the given key, and keep it
+    bool keep (std::size_t index, const Key& key)
+    {
+      if (index >= owner_.size() || !(owner_[index] == key))
+        return false;
+      used_[index] = true;
+      return true;
+    }
+
+    //! Record the entity of an index given by a full update, the first key for an index wins
+    void assign (std::size_t index, const Key& key)
+    {
+      if (index >= owner_.size())
+        owner_.resize(index+1);
+      if (owner_[index] == Key())
+        owner_[index] = key;
+    }
+
+    //! Hand the index of one entity on to another one, used for copies of elements
+    void rename (std::size_t index, const Key& key)
+    {
+      owner_[index] = key;
+    }
+
+    //! Get an index for a new entity
+    int insert (const Key& key)
+    {
+      owner_.push_back(key);
+      used_.push_back(true);
+      return owner_.size()-1;
+    }
+
+    /** \brief Close the holes of vanished entities
+        \return true if some entities have been moved
+     */
+    bool finish ()
+    {
+      const std::size_t n = std::count(used_.begin(), used_.end(), true);
+
+      // the entities with indices n and above are moved into the holes below n
+      bool moved = false;
+      std::size_t hole = 0;
+      for (std::size_t i=n; i<owner_.size(); i++)
+      {
+        if (!used_[i]) {
+          remap_.push_back(-1);
+          continue;
+        }
+        while (used_[hole])
+          hole++;
+        owner_[hole] = owner_[i];
+        remap_.push_back(hole++);
+        moved = true;
+      }
+      owner_.resize(n);
+
+      indexMap_.assign(oldSize_, -1);
+      for (std::size_t i=0; i<oldSize_; i++)
+        if (used_[i])
+          indexMap_[i] = newIndex(i);
+      used_.clear();
+
+      return moved;
+    }
+
+    //! The index after finish() of an entity which had the given index before
+    int newIndex (std::size_t index) const
+    {
+      return (index < owner_.size()) ? index : remap_[index-owner_.size()];
+    }
+
+    //! Number of entities
+    int size () const
+    {
+      return owner_.size();
+    }
+
+    //! Map from the indices before the last update to the current ones, -1 for vanished entities
+    const std::vector<int>& indexMap () const
+    {
+      return indexMap_;
+    }
+
+  private:
+    std::vector<Key> owner_;
+    std::vector<bool> used_;
+    std::vector<int> remap_;
+    std::vector<int> indexMap_;
+    std::size_t oldSize_;
+  };
+
   template<class GridImp>
   class UGGridLeafIndexSet : public IndexSet<GridImp,UGGridLeafIndexSet<GridImp>, UG::UINT>
   {
@@ -290,9 +453,67 @@ namespace Dune {
     }
 
 
-    /** \brief Update the leaf indices.  This method is called after each grid change. */
-    void update(std::vector<unsigned int>* nodePermutation=0);
+    /** \brief Map from the leaf indices before the last update to the current ones
 
+       Entry i is the current index of the entity of the given type which had index i
+       before the last grid change, or -1 if that entity has left the leaf grid.
+       The map is only available if the last update was incremental, see
+       UGGrid::setIncrementalLeafIndexUpdate(), and empty otherwise.  Users reach
+       it through UGGrid::leafIndexMap().
+     */
+    const std::vector<int>& indexMap (const GeometryType& type) const
+    {
+      return numbering(type).indexMap();
+    }
+
+    /** \brief Update the leaf indices.  This method is called after each grid change.
+        \param incremental Only number the entities whose leaf status has changed and
+        close the holes, instead of numbering all entities anew
+        \param recordKeys After numbering all entities anew, record which entity has
+        which index, so the next update can be incremental
+     */
+    void update(std::vector<unsigned int>* nodePermutation=0, bool incremental=false, bool recordKeys=false);
+
+    /** \brief Record the entities of the current indices, so the next update can be incremental
+
+        This visits all leaf entities, hence it is only done when incremental updates are
+        switched on.  The incremental updates keep the record up to date.
+     */
+    void recordLeafKeys();
+
+  private:
+    void updateIncrementally();
+
+    //! The numbering of the leaf entities of the given type
+    UGGridLeafNumbering& numbering (const GeometryType& type)
+    {
+      return const_cast<UGGridLeafNumbering&>(static_cast<const UGGridLeafIndexSet*>(this)->numbering(type));
+    }
+
+    const UGGridLeafNumbering& numbering (const GeometryType& type) const
+    {
+      if (type.dim()==dim) {
+        if (type.isSimplex())
+          return elementNumbering_[0];
+        if (type.isPyramid())
+          return elementNumbering_[1];
+        if (type.isPrism())
+          return elementNumbering_[2];
+        if (type.isCube())
+          return elementNumbering_[3];
+      }
+      else if (type.dim()==0)
+        return vertexNumbering_;
+      else if (type.dim()==1)
+        return edgeNumbering_;
+      else if (type.isTriangle())
+        return faceNumbering_[0];
+      else if (type.isQuadrilateral())
+        return faceNumbering_[1];
+      DUNE_THROW(GridError, "UGGridLeafIndexSet: no leaf entities of type " << type);
+    }
+
+  public:
     const GridImp& grid_;
 
     /** \brief The lowest level that contains leaf elements
@@ -315,6 +536,13 @@ namespace Dune {
     int numQuadFaces_;
 
     std::vector<GeometryType> myTypes_[dim+1];
+
+    // The numberings for the incremental update: simplices, pyramids, prisms, cubes
+    UGGridLeafNumbering elementNumbering_[4];
+    UGGridLeafNumbering vertexNumbering_;
+    UGGridLeafNumbering edgeNumbering_;
+    // triangles and quadrilaterals
+    UGGridLeafNumbering faceNumbering_[2];
   };
 
 
@@ -290,6 +290,11 @@ namespace Dune {
       return PARHDR(node)->prio;
     }
 
+    static DDD_HEADER* ParHdr(UG_NS< UG_DIM >::Element *element)
+    {
+      return PARHDRE(element);
+    }
+
     static DDD_HEADER* ParHdr(UG_NS< UG_DIM >::Vector *side)
     {
       return PARHDR(side);
@@ -473,6 +478,15 @@ namespace Dune {
       return ECLASS(theElement) == RED_CLASS;
     }
 
+    //! return true if element has been refined by a regular (red) rule
+    static bool isRedRefined (const UG_NS< UG_DIM >::Element* theElement) {
+      using UG_NAMESPACE ::ELEMENT;
+      using UG_NAMESPACE ::control_entries;
+      using UG::UINT;
+      using UG_NAMESPACE ::REFINECLASS_CE;
+      return REFINECLASS(theElement) == RED_CLASS;
+    }
+
     //! \todo Please doc me!
     static int Sides_Of_Elem(const UG_NS< UG_DIM >::Element* theElement) {
       using UG_NAMESPACE ::element_descriptors;
@@ -642,6 +656,11 @@ namespace Dune {
       else
         return false;
     }
+
+    //! Access to the processor an element is sent to by TransferGridFromLevel()
+    static int& Partition(UG_NS< UG_DIM >::Element* theElement) {
+      return PARTITION(theElement);
+    }
 #endif
 
     //! Return true if the element is a leaf element
@@ -1019,6 +1038,13 @@ namespace Dune {
       return UG_NAMESPACE ::LBCommand(argc, (char**)argv);
     }
 
+#ifdef ModelP
+    /** \brief Move all elements from the given level on to the processors set by Partition() */
+    static int TransferGridFromLevel(UG_NS< UG_DIM >::MultiGrid* theMG, int level) {
+      return UG_NAMESPACE ::TransferGridFromLevel(theMG, level);
+    }
+#endif
+
     static int ConfigureCommand(int argc, const char** argv) {
       /** \todo Can we remove the cast? */
       return UG_NAMESPACE ::ConfigureCommand(argc, (char**)argv);
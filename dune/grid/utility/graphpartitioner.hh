@@ -0,0 +1,640 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_GRAPHPARTITIONER_HH
+#define DUNE_GRID_GRAPHPARTITIONER_HH
+
+/**
+   @file
+   @brief Partitioning of the dual graph of a grid view for load balancing
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+
+namespace Dune
+{
+
+  /**
+     @brief Partitioner for graphs with weighted vertices
+
+     The graph is given in compressed row storage: the neighbors of
+     vertex i are adjncy[xadj[i]], ..., adjncy[xadj[i+1]-1].
+
+     The default implementation is a recursive bisection. Each bisection
+     grows one half from a pseudo-peripheral vertex until it holds its
+     share of the weight, and then moves boundary vertices to the other
+     half as long as this shortens the cut without spoiling the balance.
+     To use an external partitioning library, derive from this class and
+     overload partition().
+   */
+  class GraphPartitioner
+  {
+  public:
+    /** @param imbalance allowed relative deviation of the weight of a part from the mean */
+    explicit GraphPartitioner (double imbalance = 0.05, int refinementPasses = 4)
+      : imbalance_(imbalance), passes_(refinementPasses)
+    {}
+
+    virtual ~GraphPartitioner () {}
+
+    /**
+       @brief Partition a graph into parts of about equal weight
+
+       @param xadj offsets of the neighbor lists, size is the number of vertices plus one
+       @param adjncy concatenated neighbor lists
+       @param weight weight of each vertex
+       @param nparts number of parts
+       @param[out] part part of each vertex, in 0 ... nparts-1
+     */
+    virtual void partition (const std::vector<int>& xadj, const std::vector<int>& adjncy,
+                            const std::vector<double>& weight, int nparts,
+                            std::vector<int>& part) const
+    {
+      if (nparts<1)
+        DUNE_THROW(GridError, "GraphPartitioner: cannot partition into " << nparts << " parts");
+      if (xadj.size()!=weight.size()+1)
+        DUNE_THROW(GridError, "GraphPartitioner: xadj and weight do not fit together");
+
+      part.assign(weight.size(), 0);
+      std::vector<int> vertices(weight.size());
+      for (std::size_t i=0; i<vertices.size(); i++)
+        vertices[i] = i;
+      // side of each vertex in the current bisection, -1 for vertices outside of it
+      std::vector<int> side(weight.size(), -1);
+      bisect(xadj, adjncy, weight, vertices, 0, nparts, side, part);
+    }
+
+  private:
+    //! split vertices into the parts first, ..., first+nparts-1
+    void bisect (const std::vector<int>& xadj, const std::vector<int>& adjncy,
+                 const std::vector<double>& weight, const std::vector<int>& vertices,
+                 int first, int nparts, std::vector<int>& side, std::vector<int>& part) const
+    {
+      if (nparts==1 || vertices.size()<2)
+      {
+        for (std::size_t i=0; i<vertices.size(); i++)
+          part[vertices[i]] = first;
+        return;
+      }
+
+      const int nleft = nparts/2;
+      double total = 0.0, maxWeight = 0.0;
+      for (std::size_t i=0; i<vertices.size(); i++)
+      {
+        total += weight[vertices[i]];
+        maxWeight = std::max(maxWeight, weight[vertices[i]]);
+      }
+      const double target = total*nleft/nparts;
+      const double tolerance = std::max(imbalance_*total/nparts, maxWeight);
+
+      // all vertices start on the right side
+      for (std::size_t i=0; i<vertices.size(); i++)
+        side[vertices[i]] = 1;
+
+      // grow the left side breadth first, restarting in unreached components
+      double left = 0.0;
+      std::vector<int> queue;
+      queue.reserve(vertices.size());
+      std::size_t head = 0;
+      std::size_t nextSeed = 0;
+      int seed = peripheralVertex(xadj, adjncy, vertices[0], side);
+      while (left<target)
+      {
+        if (head==queue.size())
+        {
+          if (seed<0)
+          {
+            while (nextSeed<vertices.size() && side[vertices[nextSeed]]!=1)
+              nextSeed++;
+            if (nextSeed==vertices.size())
+              break;
+            seed = vertices[nextSeed];
+          }
+          side[seed] = 2;
+          queue.push_back(seed);
+          seed = -1;
+        }
+        const int v = queue[head++];
+        // do not overshoot by more than half of the vertex weight
+        if (left+0.5*weight[v]>target && left>0.0)
+        {
+          side[v] = 1;
+          break;
+        }
+        side[v] = 0;
+        left += weight[v];
+        for (int j=xadj[v]; j<xadj[v+1]; j++)
+          if (side[adjncy[j]]==1)
+          {
+            side[adjncy[j]] = 2;
+            queue.push_back(adjncy[j]);
+          }
+      }
+      // vertices still in the queue go back to the right side
+      for (std::size_t i=head; i<queue.size(); i++)
+        side[queue[i]] = 1;
+
+      refine(xadj, adjncy, weight, vertices, target, tolerance, side, left);
+
+      std::vector<int> leftVertices, rightVertices;
+      for (std::size_t i=0; i<vertices.size(); i++)
+      {
+        (side[vertices[i]]==0 ? leftVertices : rightVertices).push_back(vertices[i]);
+        side[vertices[i]] = -1;
+      }
+
+      bisect(xadj, adjncy, weight, leftVertices, first, nleft, side, part);
+      bisect(xadj, adjncy, weight, rightVertices, first+nleft, nparts-nleft, side, part);
+    }
+
+    //! the last vertex reached by a breadth first search from v within the current bisection
+    int peripheralVertex (const std::vector<int>& xadj, const std::vector<int>& adjncy,
+                          int v, std::vector<int>& side) const
+    {
+      std::vector<int> queue(1, v);
+      side[v] = 3;
+      for (std::size_t head=0; head<queue.size(); head++)
+      {
+        const int u = queue[head];
+        for (int j=xadj[u]; j<xadj[u+1]; j++)
+          if (side[adjncy[j]]==1)
+          {
+            side[adjncy[j]] = 3;
+            queue.push_back(adjncy[j]);
+          }
+      }
+      for (std::size_t i=0; i<queue.size(); i++)
+        side[queue[i]] = 1;
+      return queue.back();
+    }
+
+    //! move boundary vertices with positive gain while the balance stays within the tolerance
+    void refine (const std::vector<int>& xadj, const std::vector<int>& adjncy,
+                 const std::vector<double>& weight, const std::vector<int>& vertices,
+                 double target, double tolerance, std::vector<int>& side, double& left) const
+    {
+      for (int pass=0; pass<passes_; pass++)
+      {
+        bool moved = false;
+        for (std::size_t i=0; i<vertices.size(); i++)
+        {
+          const int v = vertices[i];
+          const int s = side[v];
+          int gain = 0;
+          for (int j=xadj[v]; j<xadj[v+1]; j++)
+          {
+            const int t = side[adjncy[j]];
+            if (t>=0)
+              gain += (t==s) ? -1 : 1;
+          }
+          const double newLeft = (s==0) ? left-weight[v] : left+weight[v];
+          const bool balanced = std::abs(newLeft-target)<=tolerance;
+          const bool improves = std::abs(newLeft-target)<std::abs(left-target);
+          if ((gain>0 && (balanced || improves)) || (gain==0 && improves))
+          {
+            side[v] = 1-s;
+            left = newLeft;
+            moved = true;
+          }
+        }
+        if (!moved)
+          break;
+      }
+    }
+
+    double imbalance_;
+    int passes_;
+  };
+
+  /**
+     @brief Partition the interior elements of a grid view by their dual graph
+
+     The vertices of the dual graph are the interior elements of the view,
+     two of them are connected if they share an intersection. The graph is
+     built with the global ids of the elements, gathered on rank 0, split
+     there into gv.comm().size() parts of about equal weight, and the
+     resulting ranks are sent back. The result can be passed to the
+     load balancing methods of grids which take target processors.
+
+     The target processors are indexed by a MultipleCodimMultipleGeomTypeMapper
+     of the elements of gv with MCMGElementLayout, because index sets number
+     the elements of each geometry type separately.
+
+     @note This does not scale to large process counts: rank 0 receives the
+     whole dual graph, padded to the largest local part times the number of
+     processes, and partitions it serially.  Its memory and time grow with the
+     global number of elements, so use it for the coarse grid or for moderate
+     grid sizes, and diffuseDualGraph() for incremental rebalancing.
+
+     @param weight functor returning the (positive) weight of an element
+     @param[out] targetProcessors rank of each element, indexed by the element mapper of gv.
+     Entries of non-interior elements are set to the own rank.
+   */
+  template<class GridView, class Weight>
+  void partitionDualGraph (const GridView& gv, const Weight& weight,
+                           const GraphPartitioner& partitioner,
+                           std::vector<int>& targetProcessors)
+  {
+    typedef typename GridView::Grid::GlobalIdSet::IdType IdType;
+    typedef typename GridView::template Codim<0>::template Partition<Interior_Partition>::Iterator Iterator;
+    typedef typename GridView::IntersectionIterator IntersectionIterator;
+
+    const typename GridView::Grid::GlobalIdSet& idSet = gv.grid().globalIdSet();
+    const MultipleCodimMultipleGeomTypeMapper<GridView, MCMGElementLayout> mapper(gv);
+    const int rank = gv.comm().rank();
+    const int size = gv.comm().size();
+
+    targetProcessors.assign(mapper.size(), rank);
+
+    // the local part of the graph
+    std::vector<IdType> ids;
+    std::vector<double> weights;
+    std::vector<int> degrees;
+    std::vector<IdType> neighbors;
+    const Iterator end = gv.template end<0,Interior_Partition>();
+    for (Iterator it = gv.template begin<0,Interior_Partition>(); it != end; ++it)
+    {
+      ids.push_back(idSet.id(*it));
+      weights.push_back(weight(*it));
+      int degree = 0;
+      const IntersectionIterator iend = gv.iend(*it);
+      for (IntersectionIterator iit = gv.ibegin(*it); iit != iend; ++iit)
+        if (iit->neighbor())
+        {
+          neighbors.push_back(idSet.id(*iit->outside()));
+          degree++;
+        }
+      degrees.push_back(degree);
+    }
+
+    // gather everything on rank 0, padded to the largest local size
+    const int nLocal = ids.size();
+    const int nMax = gv.comm().max(nLocal);
+    const int eMax = std::max(gv.comm().max(int(neighbors.size())), 1);
+    if (nMax==0)
+      return;
+
+    ids.resize(nMax);
+    weights.resize(nMax, 0.0);
+    degrees.resize(nMax, -1);
+    neighbors.resize(eMax);
+
+    std::vector<IdType> allIds(nMax*size);
+    std::vector<double> allWeights(nMax*size);
+    std::vector<int> allDegrees(nMax*size);
+    std::vector<IdType> allNeighbors(eMax*size);
+    gv.comm().gather(&ids[0], &allIds[0], nMax, 0);
+    gv.comm().gather(&weights[0], &allWeights[0], nMax, 0);
+    gv.comm().gather(&degrees[0], &allDegrees[0], nMax, 0);
+    gv.comm().gather(&neighbors[0], &allNeighbors[0], eMax, 0);
+
+    std::vector<int> allParts(nMax*size, rank);
+    if (rank==0)
+    {
+      // number the vertices of the global graph
+      std::map<IdType,int> vertex;
+      for (int i=0; i<nMax*size; i++)
+        if (allDegrees[i]>=0)
+          vertex.insert(std::make_pair(allIds[i], int(vertex.size())));
+
+      std::vector<int> xadj(vertex.size()+1, 0);
+      std::vector<int> adjncy;
+      std::vector<double> vwgt(vertex.size());
+      for (int i=0; i<nMax*size; i++)
+        if (allDegrees[i]>=0)
+        {
+          const int v = vertex[allIds[i]];
+          vwgt[v] = allWeights[i];
+          xadj[v+1] = allDegrees[i];
+        }
+      for (std::size_t v=0; v<vertex.size(); v++)
+        xadj[v+1] += xadj[v];
+      adjncy.resize(xadj.back());
+      for (int p=0; p<size; p++)
+      {
+        int e = p*eMax;
+        for (int i=p*nMax; i<(p+1)*nMax && allDegrees[i]>=0; i++)
+        {
+          const int v = vertex[allIds[i]];
+          for (int j=0; j<allDegrees[i]; j++, e++)
+          {
+            typename std::map<IdType,int>::const_iterator n = vertex.find(allNeighbors[e]);
+            if (n==vertex.end())
+              DUNE_THROW(GridError, "partitionDualGraph: neighbor is not an interior element on any process");
+            adjncy[xadj[v]+j] = n->second;
+          }
+        }
+      }
+
+      std::vector<int> part;
+      partitioner.partition(xadj, adjncy, vwgt, size, part);
+
+      for (int i=0; i<nMax*size; i++)
+        if (allDegrees[i]>=0)
+          allParts[i] = part[vertex[allIds[i]]];
+    }
+
+    std::vector<int> parts(nMax);
+    gv.comm().scatter(&allParts[0], &parts[0], nMax, 0);
+
+    int i = 0;
+    for (Iterator it = gv.template begin<0,Interior_Partition>(); it != end; ++it, ++i)
+      targetProcessors[mapper.map(*it)] = parts[i];
+  }
+
+  /**
+     @brief Weighted load of the processes for a distribution of the elements
+
+     The imbalance is the largest load of a process divided by the mean load,
+     so 1 means perfectly balanced.
+   */
+  struct LoadBalanceStatistics
+  {
+    LoadBalanceStatistics ()
+      : imbalance(1.0), predictedImbalance(1.0), migratedElements(0), migratedWeight(0.0)
+    {}
+
+    //! imbalance of the current distribution
+    double imbalance;
+    //! imbalance after the elements have been sent to their target processors
+    double predictedImbalance;
+    //! number of elements which change their process
+    int migratedElements;
+    //! total weight of the elements which change their process
+    double migratedWeight;
+  };
+
+  /**
+     @brief Compute the load statistics of moving the interior elements of a grid view
+
+     This is a collective operation, all processes get the same result.
+
+     @param weight functor returning the (positive) weight of an element
+     @param targetProcessors rank of each element, indexed by the element mapper of gv
+     as for partitionDualGraph()
+   */
+  template<class GridView, class Weight>
+  LoadBalanceStatistics loadBalanceStatistics (const GridView& gv, const Weight& weight,
+                                               const std::vector<int>& targetProcessors)
+  {
+    typedef typename GridView::template Codim<0>::template Partition<Interior_Partition>::Iterator Iterator;
+
+    const MultipleCodimMultipleGeomTypeMapper<GridView, MCMGElementLayout> mapper(gv);
+    const int rank = gv.comm().rank();
+    const int size = gv.comm().size();
+
+    // current loads in the first half, predicted loads in the second half
+    std::vector<double> loads(2*size, 0.0);
+    LoadBalanceStatistics statistics;
+    const Iterator end = gv.template end<0,Interior_Partition>();
+    for (Iterator it = gv.template begin<0,Interior_Partition>(); it != end; ++it)
+    {
+      const double w = weight(*it);
+      const int target = targetProcessors[mapper.map(*it)];
+      loads[rank] += w;
+      loads[size+target] += w;
+      if (target != rank)
+      {
+        statistics.migratedElements++;
+        statistics.migratedWeight += w;
+      }
+    }
+    gv.comm().sum(&loads[0], 2*size);
+    statistics.migratedElements = gv.comm().sum(statistics.migratedElements);
+    statistics.migratedWeight = gv.comm().sum(statistics.migratedWeight);
+
+    double total = 0.0, maxLoad = 0.0, maxPredicted = 0.0;
+    for (int p=0; p<size; p++)
+    {
+      total += loads[p];
+      maxLoad = std::max(maxLoad, loads[p]);
+      maxPredicted = std::max(maxPredicted, loads[size+p]);
+    }
+    if (total > 0.0)
+    {
+      statistics.imbalance = maxLoad*size/total;
+      statistics.predictedImbalance = maxPredicted*size/total;
+    }
+    return statistics;
+  }
+
+  namespace Impl
+  {
+    //! send the rank of each interior element to its ghost copies, indexed by an element mapper
+    template<class GridView>
+    class OwnerRankDataHandle
+      : public CommDataHandleIF<OwnerRankDataHandle<GridView>, int>
+    {
+    public:
+      typedef MultipleCodimMultipleGeomTypeMapper<GridView, MCMGElementLayout> Mapper;
+
+      OwnerRankDataHandle (const GridView& gv, const Mapper& mapper, std::vector<int>& owner)
+        : mapper_(mapper), rank_(gv.comm().rank()), owner_(owner)
+      {}
+
+      bool contains (int dim, int codim) const { return codim == 0; }
+
+      bool fixedsize (int dim, int codim) const { return true; }
+
+      template<class Entity>
+      std::size_t size (const Entity& e) const { return 1; }
+
+      template<class MessageBuffer, class Entity>
+      void gather (MessageBuffer& buff, const Entity& e) const
+      {
+        buff.write(rank_);
+      }
+
+      template<class MessageBuffer, class Entity>
+      void scatter (MessageBuffer& buff, const Entity& e, std::size_t n)
+      {
+        int rank;
+        buff.read(rank);
+        owner_[mapper_.map(e)] = rank;
+      }
+
+    private:
+      const Mapper& mapper_;
+      int rank_;
+      std::vector<int>& owner_;
+    };
+  }
+
+  /**
+     @brief Find the rank that owns each element of a grid view
+
+     The interior elements belong to the own process, ghost elements to the
+     process that has them as interior elements.  The grid view has to
+     provide ghost elements and the communication of element data.  This is a
+     collective operation.
+
+     @param[out] owner rank of each element, indexed by the element mapper of gv
+   */
+  template<class GridView>
+  void elementOwners (const GridView& gv, std::vector<int>& owner)
+  {
+    const MultipleCodimMultipleGeomTypeMapper<GridView, MCMGElementLayout> mapper(gv);
+    owner.assign(mapper.size(), gv.comm().rank());
+    if (gv.comm().size() == 1)
+      return;
+
+    Impl::OwnerRankDataHandle<GridView> ownerHandle(gv, mapper, owner);
+    gv.communicate(ownerHandle, InteriorBorder_All_Interface, ForwardCommunication);
+  }
+
+  /**
+     @brief Rebalance the interior elements of a grid view by moving elements to neighboring processes
+
+     Unlike partitionDualGraph(), this keeps the current distribution and only
+     sends elements at the process boundary to the process on the other side,
+     which moves far less data when the load has changed only a little, e.g.
+     after a few adaptation steps.
+
+     First the load that has to flow between neighboring processes is computed
+     by a diffusion scheme on the graph of the processes, with the loads
+     gathered on every process. Then each process hands those of its elements
+     to a neighbor that have a face with it, preferring elements with many such
+     faces, until the flow is covered. Elements further away from the boundary
+     are never moved, so a large imbalance may need several calls; use
+     loadBalanceStatistics() to check the outcome before committing it.
+
+     The grid view has to provide ghost elements to find the neighboring
+     processes, and the communication of element data.
+
+     @param weight functor returning the (positive) weight of an element
+     @param[out] targetProcessors rank of each element, indexed by the element mapper of gv
+     as for partitionDualGraph().  Entries of non-interior elements are set to the own rank.
+     @param maxIterations maximal number of steps of the diffusion scheme
+     @param tolerance the diffusion stops when no process deviates from the mean load by more than this fraction
+   */
+  template<class GridView, class Weight>
+  void diffuseDualGraph (const GridView& gv, const Weight& weight,
+                         std::vector<int>& targetProcessors,
+                         int maxIterations = 100, double tolerance = 0.01)
+  {
+    typedef typename GridView::template Codim<0>::template Partition<Interior_Partition>::Iterator Iterator;
+    typedef typename GridView::IntersectionIterator IntersectionIterator;
+    // number of faces with the neighboring process, and index of a boundary element
+    typedef std::pair<int,int> Candidate;
+
+    const MultipleCodimMultipleGeomTypeMapper<GridView, MCMGElementLayout> mapper(gv);
+    const int rank = gv.comm().rank();
+    const int size = gv.comm().size();
+
+    targetProcessors.assign(mapper.size(), rank);
+    if (size == 1)
+      return;
+
+    // find out which process owns the ghosts
+    std::vector<int> owner;
+    elementOwners(gv, owner);
+
+    // weights and boundary elements of this process
+    std::vector<double> weights(mapper.size(), 0.0);
+    std::vector<std::vector<Candidate> > candidates(size);
+    double load = 0.0;
+    int elements = 0;
+    const Iterator end = gv.template end<0,Interior_Partition>();
+    for (Iterator it = gv.template begin<0,Interior_Partition>(); it != end; ++it)
+    {
+      const int index = mapper.map(*it);
+      weights[index] = weight(*it);
+      load += weights[index];
+      elements++;
+
+      std::map<int,int> faces;
+      const IntersectionIterator iend = gv.iend(*it);
+      for (IntersectionIterator iit = gv.ibegin(*it); iit != iend; ++iit)
+        if (iit->neighbor())
+        {
+          const int other = owner[mapper.map(*iit->outside())];
+          if (other != rank)
+            faces[other]++;
+        }
+      for (std::map<int,int>::const_iterator f = faces.begin(); f != faces.end(); ++f)
+        candidates[f->first].push_back(Candidate(-f->second, index));
+    }
+
+    // the loads and the graph of the processes are known everywhere
+    std::vector<double> loads(size);
+    gv.comm().allgather(&load, 1, &loads[0]);
+    std::vector<int> neighbors(size, 0), graph(size*size);
+    for (int q=0; q<size; q++)
+      neighbors[q] = candidates[q].empty() ? 0 : 1;
+    gv.comm().allgather(&neighbors[0], size, &graph[0]);
+
+    std::vector<int> degree(size, 0);
+    for (int p=0; p<size; p++)
+      for (int q=0; q<size; q++)
+        if (p != q && (graph[p*size+q] || graph[q*size+p]))
+          degree[p]++;
+
+    double mean = 0.0;
+    for (int p=0; p<size; p++)
+      mean += loads[p];
+    mean /= size;
+
+    // first order diffusion, flow[p*size+q] is what p has to send to q
+    std::vector<double> flow(size*size, 0.0), change(size);
+    for (int k=0; k<maxIterations; k++)
+    {
+      double deviation = 0.0;
+      for (int p=0; p<size; p++)
+        deviation = std::max(deviation, std::abs(loads[p] - mean));
+      if (deviation <= tolerance*mean)
+        break;
+
+      std::fill(change.begin(), change.end(), 0.0);
+      for (int p=0; p<size; p++)
+        for (int q=p+1; q<size; q++)
+          if (graph[p*size+q] || graph[q*size+p])
+          {
+            const double f = (loads[p] - loads[q]) / (std::max(degree[p], degree[q]) + 1);
+            flow[p*size+q] += f;
+            flow[q*size+p] -= f;
+            change[p] -= f;
+            change[q] += f;
+          }
+      for (int p=0; p<size; p++)
+        loads[p] += change[p];
+    }
+
+    // hand boundary elements to the neighbors, never leaving this process empty
+    for (int q=0; q<size; q++)
+    {
+      const double outflow = flow[rank*size+q];
+      if (outflow <= 0.0)
+        continue;
+
+      std::sort(candidates[q].begin(), candidates[q].end());
+      double moved = 0.0;
+      for (std::size_t i=0; i<candidates[q].size() && elements>1; i++)
+      {
+        const int index = candidates[q][i].second;
+        if (targetProcessors[index] != rank)
+          continue;
+        // do not overshoot by more than half of the element weight
+        if (moved + 0.5*weights[index] > outflow)
+          continue;
+        targetProcessors[index] = q;
+        moved += weights[index];
+        elements--;
+      }
+    }
+  }
+
+} // end namespace Dune
+
+#endif // DUNE_GRID_GRAPHPARTITIONER_HH
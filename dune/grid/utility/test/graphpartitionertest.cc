@@ -0,0 +1,138 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+/** \file
+    \brief A unit test for the GraphPartitioner
+ */
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/grid/utility/graphpartitioner.hh>
+
+using namespace Dune;
+
+// weight of an element, heavier on the left half of the domain
+struct PositionWeight
+{
+  template <class Element>
+  double operator() (const Element& element) const
+  {
+    return (element.geometry().center()[0] < 0.5) ? 2.0 : 1.0;
+  }
+};
+
+// partition the dual graph of a YaspGrid and check the balance of the parts and the edge cut
+template <class GridView>
+void checkPartition (const GridView& gv, int nparts, int stripCut)
+{
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+  typedef typename GridView::IntersectionIterator IntersectionIterator;
+  const typename GridView::IndexSet& indexSet = gv.indexSet();
+
+  // build the dual graph by hand
+  const int n = indexSet.size(0);
+  std::vector<int> xadj(n+1, 0);
+  std::vector<std::vector<int> > neighbors(n);
+  std::vector<double> weight(n);
+  for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+  {
+    const int i = indexSet.index(*it);
+    weight[i] = PositionWeight()(*it);
+    for (IntersectionIterator iit = gv.ibegin(*it); iit != gv.iend(*it); ++iit)
+      if (iit->neighbor())
+        neighbors[i].push_back(indexSet.index(*iit->outside()));
+  }
+  std::vector<int> adjncy;
+  for (int i=0; i<n; i++)
+  {
+    adjncy.insert(adjncy.end(), neighbors[i].begin(), neighbors[i].end());
+    xadj[i+1] = adjncy.size();
+  }
+
+  std::vector<int> part;
+  GraphPartitioner().partition(xadj, adjncy, weight, nparts, part);
+
+  std::vector<double> partWeight(nparts, 0.0);
+  double total = 0.0;
+  for (int i=0; i<n; i++)
+  {
+    if (part[i] < 0 || part[i] >= nparts)
+      DUNE_THROW(GridError, "element " << i << " got the invalid part " << part[i]);
+    partWeight[part[i]] += weight[i];
+    total += weight[i];
+  }
+  for (int p=0; p<nparts; p++)
+    if (std::abs(partWeight[p] - total/nparts) > 0.05*total/nparts + 2.0)
+      DUNE_THROW(GridError, "part " << p << " has weight " << partWeight[p]
+                                    << ", the mean is " << total/nparts);
+
+  // the cut has to be comparable to cutting the grid into straight strips,
+  // a partition ignoring the adjacency cuts most of the edges
+  int cut = 0;
+  for (int i=0; i<n; i++)
+    for (int j=xadj[i]; j<xadj[i+1]; j++)
+      if (part[i] != part[adjncy[j]])
+        cut++;
+  cut /= 2;
+  if (cut > 2*stripCut)
+    DUNE_THROW(GridError, nparts << " parts cut " << cut << " edges, straight strips only cut " << stripCut);
+
+  std::cout << nparts << " parts of weight " << total/nparts << " with " << cut << " cut edges checked" << std::endl;
+}
+
+int main (int argc , char **argv)
+try {
+
+  // this method calls MPI_Init, if MPI is enabled
+  MPIHelper::instance(argc,argv);
+
+  FieldVector<double,2> L(1.0);
+  array<int,2> s;
+  s[0] = 24; s[1] = 16;
+  YaspGrid<2> grid(L, s);
+
+  // strips perpendicular to the longer side cut s[1] edges each
+  for (int nparts = 1; nparts <= 7; nparts++)
+    checkPartition(grid.leafView(), nparts, (nparts-1)*s[1]);
+
+  // the grid lives on one process, so the dual graph partitioning keeps everything local
+  std::vector<int> targetProcessors;
+  partitionDualGraph(grid.leafView(), PositionWeight(), GraphPartitioner(), targetProcessors);
+  for (std::size_t i=0; i<targetProcessors.size(); i++)
+    if (targetProcessors[i] != 0)
+      DUNE_THROW(GridError, "element " << i << " was sent to " << targetProcessors[i]);
+
+  // the same holds for the diffusion, and nothing moves
+  diffuseDualGraph(grid.leafView(), PositionWeight(), targetProcessors);
+  for (std::size_t i=0; i<targetProcessors.size(); i++)
+    if (targetProcessors[i] != 0)
+      DUNE_THROW(GridError, "element " << i << " was diffused to " << targetProcessors[i]);
+  LoadBalanceStatistics statistics = loadBalanceStatistics(grid.leafView(), PositionWeight(), targetProcessors);
+  if (statistics.migratedElements != 0 || statistics.migratedWeight != 0.0
+      || std::abs(statistics.imbalance - 1.0) > 1e-12 || std::abs(statistics.predictedImbalance - 1.0) > 1e-12)
+    DUNE_THROW(GridError, "wrong statistics on one process: imbalance " << statistics.imbalance
+                                                                      << ", " << statistics.migratedElements << " elements migrated");
+
+  // and every element belongs to this process
+  std::vector<int> owner;
+  elementOwners(grid.leafView(), owner);
+  if (owner.size() != (std::size_t)grid.size(0) || std::count(owner.begin(), owner.end(), 0) != grid.size(0))
+    DUNE_THROW(GridError, "elements on one process are owned by another process");
+
+  return 0;
+
+}
+catch (Exception &e) {
+  std::cerr << e << std::endl;
+  return 1;
+} catch (...) {
+  std::cerr << "Generic exception!" << std::endl;
+  return 2;
+}
@@ -7,6 +7,7 @@
 #include <vector>
 #include <algorithm>
 #include <stack>
+#include <map>
 
 // either include stdint.h or provide fallback for uint8_t
 #if HAVE_STDINT_H
@@ -17,6 +18,7 @@ typedef unsigned char uint8_t;
 
 #include <dune/grid/common/grid.hh>     // the grid base classes
 #include <dune/grid/yaspgrid/grids.hh>  // the yaspgrid base classes
+#include <dune/grid/yaspgrid/coordinates.hh>  // the coordinate policies
 #include <dune/grid/common/capabilities.hh> // the capabilities
 #include <dune/common/misc.hh>
 #include <dune/common/shared_ptr.hh>
@@ -59,7 +61,7 @@ namespace Dune {
   //************************************************************************
   // forward declaration of templates
 
-  template<int dim>                             class YaspGrid;
+  template<int dim, class Coordinates = EquidistantCoordinates<yaspgrid_ctype,dim> > class YaspGrid;
   template<int mydim, int cdim, class GridImp>  class YaspGeometry;
   template<int codim, int dim, class GridImp>   class YaspEntity;
   template<int codim, class GridImp>            class YaspEntityPointer;
@@ -70,18 +72,19 @@ namespace Dune {
   template<class GridImp>            class YaspHierarchicIterator;
   template<class GridImp, bool isLeafIndexSet>                     class YaspIndexSet;
   template<class GridImp>            class YaspGlobalIdSet;
+  template<class GridImp, class DataHandleImp> class YaspCommunication;
 
   namespace FacadeOptions
   {
 
-    template<int dim, int mydim, int cdim>
-    struct StoreGeometryReference<mydim, cdim, YaspGrid<dim>, YaspGeometry>
+    template<int dim, class Coordinates, int mydim, int cdim>
+    struct StoreGeometryReference<mydim, cdim, YaspGrid<dim,Coordinates>, YaspGeometry>
     {
       static const bool v = false;
     };
 
-    template<int dim, int mydim, int cdim>
-    struct StoreGeometryReference<mydim, cdim, const YaspGrid<dim>, YaspGeometry>
+    template<int dim, class Coordinates, int mydim, int cdim>
+    struct StoreGeometryReference<mydim, cdim, const YaspGrid<dim,Coordinates>, YaspGeometry>
     {
       static const bool v = false;
     };
@@ -98,23 +101,25 @@ namespace Dune {
 #include <dune/grid/yaspgrid/yaspgridentityseed.hh>
 #include <dune/grid/yaspgrid/yaspgridentitypointer.hh>
 #include <dune/grid/yaspgrid/yaspgridleveliterator.hh>
+#include <dune/grid/yaspgrid/yaspgridtiling.hh>
 #include <dune/grid/yaspgrid/yaspgridindexsets.hh>
 #include <dune/grid/yaspgrid/yaspgrididset.hh>
+#include <dune/grid/yaspgrid/yaspgridcommunication.hh>
 
 namespace Dune {
 
-  template<int dim>
+  template<int dim, class Coordinates>
   struct YaspGridFamily
   {
 #if HAVE_MPI
     typedef CollectiveCommunication<MPI_Comm> CCType;
 #else
-    typedef CollectiveCommunication<Dune::YaspGrid<dim> > CCType;
+    typedef CollectiveCommunication<Dune::YaspGrid<dim,Coordinates> > CCType;
 #endif
 
     typedef GridTraits<dim,                                     // dimension of the grid
         dim,                                                    // dimension of the world space
-        Dune::YaspGrid<dim>,
+        Dune::YaspGrid<dim,Coordinates>,
         YaspGeometry,YaspEntity,
         YaspEntityPointer,
         YaspLevelIterator,                                      // type used for the level iterator
@@ -124,11 +129,11 @@ namespace Dune {
         YaspIntersectionIterator,              // level intersection iter
         YaspHierarchicIterator,
         YaspLevelIterator,                                      // type used for the leaf(!) iterator
-        YaspIndexSet< const YaspGrid< dim >, false >,                  // level index set
-        YaspIndexSet< const YaspGrid< dim >, true >,                  // leaf index set
-        YaspGlobalIdSet<const YaspGrid<dim> >,
+        YaspIndexSet< const YaspGrid<dim,Coordinates>, false >,                  // level index set
+        YaspIndexSet< const YaspGrid<dim,Coordinates>, true >,                  // leaf index set
+        YaspGlobalIdSet<const YaspGrid<dim,Coordinates> >,
         bigunsignedint<dim*yaspgrid_dim_bits+yaspgrid_level_bits+yaspgrid_codim_bits>,
-        YaspGlobalIdSet<const YaspGrid<dim> >,
+        YaspGlobalIdSet<const YaspGrid<dim,Coordinates> >,
         bigunsignedint<dim*yaspgrid_dim_bits+yaspgrid_level_bits+yaspgrid_codim_bits>,
         CCType,
         DefaultLevelGridViewTraits, DefaultLeafGridViewTraits,
@@ -138,35 +143,54 @@ namespace Dune {
 
   template<int dim, int codim>
   struct YaspCommunicateMeta {
-    template<class G, class DataHandle>
-    static void comm (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    template<class G, class DataHandle, class Comm>
+    static void begin (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Comm& comm)
     {
       if (data.contains(dim,codim))
       {
         DUNE_THROW(GridError, "interface communication not implemented");
       }
-      YaspCommunicateMeta<dim,codim-1>::comm(g,data,iftype,dir,level);
+      YaspCommunicateMeta<dim,codim-1>::begin(g,data,iftype,dir,level,comm);
+    }
+
+    template<class G, class Comm>
+    static void finish (const G& g, Comm& comm)
+    {
+      YaspCommunicateMeta<dim,codim-1>::finish(g,comm);
     }
   };
 
   template<int dim>
   struct YaspCommunicateMeta<dim,dim> {
-    template<class G, class DataHandle>
-    static void comm (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    template<class G, class DataHandle, class Comm>
+    static void begin (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Comm& comm)
     {
       if (data.contains(dim,dim))
-        g.template communicateCodim<DataHandle,dim>(data,iftype,dir,level);
-      YaspCommunicateMeta<dim,dim-1>::comm(g,data,iftype,dir,level);
+        g.template communicateCodimBegin<Comm,dim>(data,iftype,dir,level,comm);
+      YaspCommunicateMeta<dim,dim-1>::begin(g,data,iftype,dir,level,comm);
+    }
+
+    template<class G, class Comm>
+    static void finish (const G& g, Comm& comm)
+    {
+      g.template communicateCodimFinish<Comm,dim>(comm);
+      YaspCommunicateMeta<dim,dim-1>::finish(g,comm);
     }
   };
 
   template<int dim>
   struct YaspCommunicateMeta<dim,0> {
-    template<class G, class DataHandle>
-    static void comm (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    template<class G, class DataHandle, class Comm>
+    static void begin (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Comm& comm)
     {
       if (data.contains(dim,0))
-        g.template communicateCodim<DataHandle,0>(data,iftype,dir,level);
+        g.template communicateCodimBegin<Comm,0>(data,iftype,dir,level,comm);
+    }
+
+    template<class G, class Comm>
+    static void finish (const G& g, Comm& comm)
+    {
+      g.template communicateCodimFinish<Comm,0>(comm);
     }
   };
 
@@ -183,21 +207,41 @@ namespace Dune {
      periodic boundaries and fast implementation allowing on-the-fly computations.
 
      \tparam dim The dimension of the grid and its surrounding world
+     \tparam Coordinates The coordinate policy, EquidistantCoordinates (the default)
+             or TensorProductCoordinates, see coordinates.hh
 
      \par History:
      \li started on July 31, 2004 by PB based on abstractions developed in summer 2003
    */
-  template<int dim>
+  template<int dim, class Coordinates>
   class YaspGrid :
-    public GridDefaultImplementation<dim,dim,yaspgrid_ctype,YaspGridFamily<dim> >,
+    public GridDefaultImplementation<dim,dim,yaspgrid_ctype,YaspGridFamily<dim,Coordinates> >,
     public MultiYGrid<dim,yaspgrid_ctype>
   {
-    typedef const YaspGrid<dim> GridImp;
+    typedef const YaspGrid<dim,Coordinates> GridImp;
+
+    dune_static_assert(( is_same<typename Coordinates::ctype,yaspgrid_ctype>::value ), "Coordinates must use yaspgrid_ctype");
 
     void init()
     {
+      // coordinates of the coarse grid with the mesh size of the level 0 grid
+      const YGrid<dim,ctype>& cg = MultiYGrid<dim,ctype>::begin().cell_global();
+      FieldVector<ctype, dim> L;
+      Dune::array<int, dim> s;
+      for (int i=0; i<dim; i++)
+      {
+        s[i] = cg.size(i);
+        L[i] = cg.size(i)*cg.meshsize(i);
+      }
+      init(Coordinates(L,s));
+    }
+
+    void init (const Coordinates& coordinates)
+    {
+      blockedTraversal = false;
+      levelCoordinates.push_back(coordinates);
       setsizes();
-      indexsets.push_back( make_shared< YaspIndexSet<const YaspGrid<dim>, false > >(*this,0) );
+      indexsets.push_back( make_shared< YaspIndexSet<const YaspGrid<dim,Coordinates>, false > >(*this,0) );
       boundarysegmentssize();
     }
 
@@ -242,14 +286,17 @@ namespace Dune {
     typedef bigunsignedint<dim*yaspgrid_dim_bits+yaspgrid_level_bits+yaspgrid_codim_bits> PersistentIndexType;
 
     //! the GridFamily of this grid
-    typedef YaspGridFamily<dim> GridFamily;
+    typedef YaspGridFamily<dim,Coordinates> GridFamily;
     // the Traits
-    typedef typename YaspGridFamily<dim>::Traits Traits;
+    typedef typename YaspGridFamily<dim,Coordinates>::Traits Traits;
 
     // need for friend declarations in entity
-    typedef YaspIndexSet<YaspGrid<dim>, false > LevelIndexSetType;
-    typedef YaspIndexSet<YaspGrid<dim>, true > LeafIndexSetType;
-    typedef YaspGlobalIdSet<YaspGrid<dim> > GlobalIdSetType;
+    typedef YaspIndexSet<YaspGrid<dim,Coordinates>, false > LevelIndexSetType;
+    typedef YaspIndexSet<YaspGrid<dim,Coordinates>, true > LeafIndexSetType;
+    typedef YaspGlobalIdSet<YaspGrid<dim,Coordinates> > GlobalIdSetType;
+
+    //! the coordinate policy
+    typedef Coordinates CoordinatesType;
 
     //! maximum number of levels allowed
     enum { MAXL=64 };
@@ -404,10 +451,84 @@ namespace Dune {
       init();
     }
 
+    /*! Constructor for a YaspGrid with tensor-product coordinates
+
+       Only available with the TensorProductCoordinates policy.
+       @param comm MPI communicator where this mesh is distributed to
+       @param coords increasing vertex coordinates of the coarse mesh in each direction
+       @param periodic tells if direction is periodic or not
+       @param overlap size of overlap on coarsest grid (same in all directions)
+       @param lb pointer to an overloaded YLoadBalance instance
+     */
+    YaspGrid (Dune::MPIHelper::MPICommunicator comm,
+              const Dune::array<std::vector<ctype>, dim>& coords,
+              std::bitset<dim> periodic,
+              int overlap,
+              const YLoadBalance<dim>* lb = defaultLoadbalancer())
+#if HAVE_MPI
+      : YMG(comm,coordinatesExtension(coords),coordinatesCells(coords),periodic,overlap,lb), ccobj(comm),
+        leafIndexSet_(*this),
+        keep_ovlp(true), adaptRefCount(0), adaptActive(false)
+#else
+      : YMG(coordinatesExtension(coords),coordinatesCells(coords),periodic,overlap,lb),
+        leafIndexSet_(*this),
+        keep_ovlp(true), adaptRefCount(0), adaptActive(false)
+#endif
+    {
+      init(Coordinates(coords));
+    }
+
+    /*! Constructor for a sequential YaspGrid with tensor-product coordinates
+
+       Only available with the TensorProductCoordinates policy.
+       @param coords increasing vertex coordinates of the coarse mesh in each direction
+       @param periodic tells if direction is periodic or not
+       @param overlap size of overlap on coarsest grid (same in all directions)
+       @param lb pointer to an overloaded YLoadBalance instance
+     */
+    YaspGrid (const Dune::array<std::vector<ctype>, dim>& coords,
+              std::bitset<dim> periodic = std::bitset<dim>(),
+              int overlap = 0,
+              const YLoadBalance<dim>* lb = YMG::defaultLoadbalancer())
+#if HAVE_MPI
+      : YMG(MPI_COMM_SELF,coordinatesExtension(coords),coordinatesCells(coords),periodic,overlap,lb), ccobj(MPI_COMM_SELF),
+        leafIndexSet_(*this),
+        keep_ovlp(true), adaptRefCount(0), adaptActive(false)
+#else
+      : YMG(coordinatesExtension(coords),coordinatesCells(coords),periodic,overlap,lb),
+        leafIndexSet_(*this),
+        keep_ovlp(true), adaptRefCount(0), adaptActive(false)
+#endif
+    {
+      init(Coordinates(coords));
+    }
+
   private:
     // do not copy this class
     YaspGrid(const YaspGrid&);
 
+    // length of the domain given by vertex coordinates
+    static FieldVector<ctype, dim> coordinatesExtension (const Dune::array<std::vector<ctype>, dim>& coords)
+    {
+      FieldVector<ctype, dim> L;
+      for (int i=0; i<dim; i++)
+        L[i] = coords[i].empty() ? 0.0 : coords[i].back()-coords[i].front();
+      return L;
+    }
+
+    // number of cells given by vertex coordinates
+    static Dune::array<int, dim> coordinatesCells (const Dune::array<std::vector<ctype>, dim>& coords)
+    {
+      Dune::array<int, dim> s;
+      for (int i=0; i<dim; i++)
+      {
+        if (coords[i].size()<2)
+          DUNE_THROW(GridError, "YaspGrid needs at least two coordinates in direction " << i);
+        s[i] = coords[i].size()-1;
+      }
+      return s;
+    }
+
   public:
 
     /*! Return maximum level defined in this grid. Levels are numbered
@@ -418,20 +539,25 @@ namespace Dune {
     //! refine the grid refCount times. What about overlap?
     void globalRefine (int refCount)
     {
+      // the communication plans refer to the grid levels
+      commPlans.clear();
+
       if (refCount < -maxLevel())
         DUNE_THROW(GridError, "Only " << maxLevel() << " levels left. " <<
                    "Coarsening " << -refCount << " levels requested!");
       for (int k=refCount; k<0; k++)
       {
         MultiYGrid<dim,ctype>::coarsen();
+        levelCoordinates.pop_back();
         setsizes();
         indexsets.pop_back();
       }
       for (int k=0; k<refCount; k++)
       {
         MultiYGrid<dim,ctype>::refine(keep_ovlp);
+        levelCoordinates.push_back(levelCoordinates.back().refine());
         setsizes();
-        indexsets.push_back( make_shared<YaspIndexSet<const YaspGrid<dim>, false > >(*this,maxLevel()) );
+        indexsets.push_back( make_shared<YaspIndexSet<const YaspGrid<dim,Coordinates>, false > >(*this,maxLevel()) );
       }
     }
 
@@ -444,6 +570,33 @@ namespace Dune {
       keep_ovlp = keepPhysicalOverlap;
     }
 
+    /**
+       \brief set the order in which level and leaf iterators traverse the cells
+
+       The cells of each iterated subgrid are divided into blocks of the given size,
+       the blocks are traversed in lexicographic order and the cells within each block
+       as well. For small blocks, neighboring cells in all directions are visited close
+       in time, which keeps their data cached. The index sets are not affected,
+       they still number the cells lexicographically. Vertex iterators, intersection
+       iterators and tiles (see tiles()) always traverse lexicographically.
+       The order must not be changed while cells are iterated.
+       @param block size of the blocks per direction, all entries must be positive
+     */
+    void cellTraversalBlock (const FieldVector<int, dim>& block)
+    {
+      for (int i=0; i<dim; i++)
+        if (block[i]<1)
+          DUNE_THROW(GridError, "block size must be positive");
+      traversalBlock = block;
+      blockedTraversal = true;
+    }
+
+    //! restore the lexicographic traversal of the cells, see cellTraversalBlock()
+    void cellTraversalLexicographic ()
+    {
+      blockedTraversal = false;
+    }
+
     /** \brief Marks an entity to be refined/coarsened in a subsequent adapt.
 
        \param[in] refCount Number of subdivisions that should be applied. Negative value means coarsening.
@@ -552,6 +705,92 @@ namespace Dune {
       return levelend<cd,All_Partition>(maxLevel());
     }
 
+    //! a contiguous block of interior cells, see tiles()
+    typedef YaspTile<GridImp> Tile;
+
+    /** \brief split the interior cells of a level into tiles for concurrent processing
+
+       The tiles consist of consecutive cells in lexicographic order: a tile spans
+       the whole interior in the directions below some direction k, a range of layers
+       in direction k and a single layer in the directions above k, where k is chosen
+       as large as the tile size allows.
+       @param level the grid level
+       @param maxcells maximum number of cells of a tile
+     */
+    std::vector<Tile> tiles (int level, int maxcells = Tile::defaultSize) const
+    {
+      if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
+      if (maxcells<1) DUNE_THROW(GridError, "a tile needs at least one cell");
+      YGLI g = MultiYGrid<dim,ctype>::begin(level);
+      const SubYGrid<dim,ctype>& interior = g.cell_interior();
+      std::vector<Tile> result;
+      if (interior.totalsize()==0) return result;
+
+      // cut direction k and number of cells of one layer in direction k
+      int k = 0;
+      int layer = 1;
+      while (k<dim-1 && layer*interior.size(k)<=maxcells)
+        layer *= interior.size(k++);
+      const int m = std::max(1,maxcells/layer);
+
+      // number of tiles stacked in the directions above k
+      int outer = 1;
+      for (int i=k+1; i<dim; i++) outer *= interior.size(i);
+
+      FieldVector<int, dim> tileorigin, tilesize;
+      for (int n=0; n<outer; n++)
+      {
+        int rest = n;
+        for (int i=0; i<dim; i++)
+        {
+          if (i<k)
+          {
+            tileorigin[i] = interior.origin(i);
+            tilesize[i] = interior.size(i);
+          }
+          else if (i>k)
+          {
+            tileorigin[i] = interior.origin(i) + rest%interior.size(i);
+            rest /= interior.size(i);
+            tilesize[i] = 1;
+          }
+        }
+        for (int c=0; c<interior.size(k); c+=m)
+        {
+          tileorigin[k] = interior.origin(k)+c;
+          tilesize[k] = std::min(m,interior.size(k)-c);
+          YGrid<dim,ctype> box(tileorigin,tilesize,interior.meshsize(),interior.shift());
+          result.push_back(Tile(this,g,interior.intersection(box)));
+        }
+      }
+      return result;
+    }
+
+    //! split the interior cells of the leaf level into tiles, see tiles()
+    std::vector<Tile> leafTiles (int maxcells = Tile::defaultSize) const
+    {
+      return tiles(maxLevel(),maxcells);
+    }
+
+    /** \brief index of the neighbor across an intersection
+
+       Returns the index of the outside element in the index set of the level of the
+       inside element, i.e. in the leaf index set for leaf intersections, or -1 if the
+       neighbor does not exist in this process. The index is computed from the index
+       of the inside element, no entity pointer to the neighbor is constructed.
+       Level and leaf intersections have the same type.
+     */
+    int outsideIndex (const typename Traits::LeafIntersection& intersection) const
+    {
+      return this->getRealImplementation(intersection).outsideIndex();
+    }
+
+    //! return true if the intersection lies on a periodic boundary, i.e. its neighbor is a periodic image
+    bool periodic (const typename Traits::LeafIntersection& intersection) const
+    {
+      return this->getRealImplementation(intersection).periodic();
+    }
+
     // \brief obtain EntityPointer from EntitySeed. */
     template <typename Seed>
     typename Traits::template Codim<Seed::codimension>::EntityPointer
@@ -559,14 +798,15 @@ namespace Dune {
     {
       const int codim = Seed::codimension;
       YGLI g = MultiYGrid<dim,ctype>::begin(this->getRealImplementation(seed).level());
+      const int index = this->getRealImplementation(seed).index();
       switch (codim)
       {
       case 0 :
         return YaspEntityPointer<codim,GridImp>(this,g,
-                                                TSI(g.cell_overlap(), this->getRealImplementation(seed).coord()));
+                                                TSI(g.cell_overlap(), decodeIndex(g.cell_overlap(),index)));
       case dim :
         return YaspEntityPointer<codim,GridImp>(this,g,
-                                                TSI(g.vertex_overlap(), this->getRealImplementation(seed).coord()));
+                                                TSI(g.vertex_overlapfront(), decodeIndex(g.vertex_overlapfront(),index)));
       default :
         DUNE_THROW(GridError, "YaspEntityPointer: codim not implemented");
       }
@@ -635,7 +875,9 @@ namespace Dune {
     template<class DataHandleImp, class DataType>
     void communicate (CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir, int level) const
     {
-      YaspCommunicateMeta<dim,dim>::comm(*this,data,iftype,dir,level);
+      YaspCommunication<GridImp,DataHandleImp> handle;
+      communicateBegin(handle,data,iftype,dir,level);
+      communicateFinish(handle);
     }
 
     /*! The new communication interface
@@ -645,32 +887,167 @@ namespace Dune {
     template<class DataHandleImp, class DataType>
     void communicate (CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir) const
     {
-      YaspCommunicateMeta<dim,dim>::comm(*this,data,iftype,dir,this->maxLevel());
+      communicate(data,iftype,dir,this->maxLevel());
     }
 
-    /*! The new communication interface
+    /*! \brief start a split-phase communication of objects for all codims on a given level
+
+       All data is gathered and the messages are posted, then the method returns
+       without waiting for the messages to arrive. The communication is completed by
+       communicateFinish() or YaspCommunication::finish(). A pending communication
+       associated with handle is finished first.
+
+       @param handle handle of the communication, must remain valid until the communication has finished
+       @param data data handle, must remain valid until the communication has finished
+       @param iftype interface to communicate on
+       @param dir direction of the communication
+       @param level grid level
+     */
+    template<class DataHandleImp, class DataType>
+    void communicateBegin (YaspCommunication<GridImp,DataHandleImp>& handle,
+                           CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      handle.finish();
+      handle._yg = this;
+      handle._data = &data;
+      YaspCommunicateMeta<dim,dim>::begin(*this,data,iftype,dir,level,handle);
+    }
 
-       communicate objects for one codim
+    //! start a split-phase communication of objects for all codims on the leaf grid
+    template<class DataHandleImp, class DataType>
+    void communicateBegin (YaspCommunication<GridImp,DataHandleImp>& handle,
+                           CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir) const
+    {
+      communicateBegin(handle,data,iftype,dir,this->maxLevel());
+    }
+
+    //! wait for a communication started by communicateBegin() and scatter the received data
+    template<class DataHandleImp>
+    void communicateFinish (YaspCommunication<GridImp,DataHandleImp>& handle) const
+    {
+      if (!handle.pending()) return;
+      YaspCommunicateMeta<dim,dim>::finish(*this,handle);
+      handle._yg = 0;
+      handle._data = 0;
+    }
+
+    /*! \brief communicate data stored in a vector indexed by the level index set
+
+       This is a fast path for the common case of a fixed number of values per entity
+       which are stored consecutively in a vector, i.e. the values of entity e are
+       data[k*index(e)], ..., data[k*index(e)+k-1] where k is determined from the size
+       of the vector. The data is packed and unpacked with one block copy per row of
+       entities in the message, without constructing entities or calling a data handle.
+       Received values overwrite the local values.
+
+       @param data the data, its size must be a multiple of size(level,codim)
+       @param codim codimension of the entities (0 or dim)
+       @param iftype interface to communicate on
+       @param dir direction of the communication
+       @param level grid level
      */
-    template<class DataHandle, int codim>
-    void communicateCodim (DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level) const
+    template<class T>
+    void communicateVector (std::vector<T>& data, int codim, InterfaceType iftype, CommunicationDirection dir, int level) const
     {
+      typedef typename YaspCommunicationPlan<dim,ctype>::Message Message;
+      typedef typename std::vector<Message>::const_iterator MIT;
+
       // check input
-      if (!data.contains(dim,codim)) return; // should have been checked outside
+      if (codim!=0 && codim!=dim)
+        DUNE_THROW(GridError, "interface communication not implemented");
+      const size_t n = size(level,codim);
+      if (n==0 || data.size()%n!=0)
+        DUNE_THROW(GridError, "size of data vector (" << data.size() << ") is not a multiple of the number of entities (" << n << ")");
+      const size_t blocksize = data.size()/n;
+
+      // get the message layout
+      shared_ptr<const YaspCommunicationPlan<dim,ctype> > plan = communicationPlan(codim,iftype,dir,level);
+      if (plan.get()==0)
+        return; // there is nothing to do in this case
+
+      // all messages are packed into one send and one receive buffer
+      size_t sendsize=0;
+      for (MIT m=plan->sends().begin(); m!=plan->sends().end(); ++m)
+        sendsize += m->indices.size()*blocksize;
+      size_t recvsize=0;
+      for (MIT m=plan->recvs().begin(); m!=plan->recvs().end(); ++m)
+        recvsize += m->indices.size()*blocksize;
+      std::vector<T> sendbuf(sendsize);
+      std::vector<T> recvbuf(recvsize);
+
+      // pack the send buffer; entities in a row of the intersection have consecutive indices
+      T* p = bufferPointer(sendbuf);
+      for (MIT m=plan->sends().begin(); m!=plan->sends().end(); ++m)
+      {
+        T* start = p;
+        const size_t rowlength = m->intersection->grid.size(0);
+        for (size_t k=0; k<m->indices.size(); k+=rowlength)
+          p = std::copy(data.begin()+m->indices[k]*blocksize, data.begin()+(m->indices[k]+rowlength)*blocksize, p);
+        MultiYGrid<dim,ctype>::torus().send(m->rank,start,(p-start)*sizeof(T));
+      }
 
-      // data types
-      typedef typename DataHandle::DataType DataType;
+      // store receive requests
+      p = bufferPointer(recvbuf);
+      for (MIT m=plan->recvs().begin(); m!=plan->recvs().end(); ++m)
+      {
+        MultiYGrid<dim,ctype>::torus().recv(m->rank,p,m->indices.size()*blocksize*sizeof(T));
+        p += m->indices.size()*blocksize;
+      }
+
+      // exchange all buffers now
+      MultiYGrid<dim,ctype>::torus().exchange();
+
+      // unpack the receive buffer
+      const T* q = bufferPointer(recvbuf);
+      for (MIT m=plan->recvs().begin(); m!=plan->recvs().end(); ++m)
+      {
+        const size_t rowlength = m->intersection->grid.size(0);
+        for (size_t k=0; k<m->indices.size(); k+=rowlength)
+        {
+          std::copy(q, q+rowlength*blocksize, data.begin()+m->indices[k]*blocksize);
+          q += rowlength*blocksize;
+        }
+      }
+    }
+
+    /*! \brief communicate data stored in a vector indexed by the leaf index set
+
+       \see communicateVector(std::vector<T>&,int,InterfaceType,CommunicationDirection,int) const
+     */
+    template<class T>
+    void communicateVector (std::vector<T>& data, int codim, InterfaceType iftype, CommunicationDirection dir) const
+    {
+      communicateVector(data,codim,iftype,dir,this->maxLevel());
+    }
+
+    /*! \brief return the precomputed layout of the messages for one communication
+
+       The plan is computed on first use and cached until the grid is refined or coarsened.
+       A null pointer is returned if there is nothing to communicate for the given
+       codim and interface.
+
+       @param codim codimension of the communicated entities (0 or dim)
+       @param iftype interface to communicate on
+       @param dir direction of the communication
+       @param level grid level
+     */
+    shared_ptr<const YaspCommunicationPlan<dim,ctype> >
+    communicationPlan (int codim, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      // look up the plan in the cache
+      const int key = ((level*(dim+1)+codim)*5+int(iftype))*2+int(dir);
+      typename CommunicationPlanMap::const_iterator cached = commPlans.find(key);
+      if (cached!=commPlans.end())
+        return cached->second;
 
       // access to grid level
       YGLI g = MultiYGrid<dim,ctype>::begin(level);
 
-      // find send/recv lists or throw error
+      // find send/recv lists
       const std::deque<IS>* sendlist=0;
       const std::deque<IS>* recvlist=0;
       if (codim==0) // the elements
       {
-        if (iftype==InteriorBorder_InteriorBorder_Interface)
-          return; // there is nothing to do in this case
         if (iftype==InteriorBorder_All_Interface)
         {
           sendlist = &g.send_cell_interior_overlap();
@@ -711,49 +1088,89 @@ namespace Dune {
       if (dir==BackwardCommunication)
         std::swap(sendlist,recvlist);
 
+      // make plan, there is nothing to do if no lists were found
+      shared_ptr<const YaspCommunicationPlan<dim,ctype> > plan;
+      if (sendlist!=0)
+        plan = make_shared<YaspCommunicationPlan<dim,ctype> >(level,*sendlist,*recvlist);
+      commPlans[key] = plan;
+      return plan;
+    }
+
+    /*! The new communication interface
+
+       start the communication of objects for one codim
+     */
+    template<class Comm, int codim>
+    void communicateCodimBegin (typename Comm::DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Comm& handle) const
+    {
+      // check input
+      if (!data.contains(dim,codim)) return; // should have been checked outside
+
+      // data types
+      typedef typename Comm::DataType DataType;
+      typedef typename YaspCommunicationPlan<dim,ctype>::Message Message;
+      typedef typename std::vector<Message>::const_iterator MIT;
+
+      // get the message layout
+      shared_ptr<const YaspCommunicationPlan<dim,ctype> > plan = communicationPlan(codim,iftype,dir,level);
+      if (plan.get()==0)
+        return; // there is nothing to do in this case
+      const std::vector<Message>& sendlist = plan->sends();
+      const std::vector<Message>& recvlist = plan->recvs();
+
+      // access to grid level
+      YGLI g = MultiYGrid<dim,ctype>::begin(level);
+
+      // the state of this codim is kept in the communication handle,
+      // buffers of previous communications are reused
+      typename Comm::CodimState& state = handle._state[codim];
+      state.plan = plan;
+      state.sends.resize(sendlist.size());
+      state.recvs.resize(recvlist.size());
+
       int cnt;
 
       // Size computation (requires communication if variable size)
-      std::vector<int> send_size(sendlist->size(),-1);    // map rank to total number of objects (of type DataType) to be sent
-      std::vector<int> recv_size(recvlist->size(),-1);    // map rank to total number of objects (of type DataType) to be recvd
-      std::vector<size_t*> send_sizes(sendlist->size(),static_cast<size_t*>(0)); // map rank to array giving number of objects per entity to be sent
-      std::vector<size_t*> recv_sizes(recvlist->size(),static_cast<size_t*>(0)); // map rank to array giving number of objects per entity to be recvd
+      std::vector<int> send_size(sendlist.size(),-1);    // map rank to total number of objects (of type DataType) to be sent
+      std::vector<int> recv_size(recvlist.size(),-1);    // map rank to total number of objects (of type DataType) to be recvd
       if (data.fixedsize(dim,codim))
       {
         // fixed size: just take a dummy entity, size can be computed without communication
         cnt=0;
-        for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
+        for (MIT m=sendlist.begin(); m!=sendlist.end(); ++m)
         {
           typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
-          send_size[cnt] = is->grid.totalsize() * data.size(*it);
+          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubbegin()));
+          send_size[cnt] = m->intersection->grid.totalsize() * data.size(*it);
           cnt++;
         }
         cnt=0;
-        for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
+        for (MIT m=recvlist.begin(); m!=recvlist.end(); ++m)
         {
           typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
-          recv_size[cnt] = is->grid.totalsize() * data.size(*it);
+          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubbegin()));
+          recv_size[cnt] = m->intersection->grid.totalsize() * data.size(*it);
           cnt++;
         }
       }
       else
       {
         // variable size case: sender side determines the size
+        std::vector<std::vector<size_t> > send_sizes(sendlist.size()); // map rank to array giving number of objects per entity to be sent
+        state.recv_sizes.resize(recvlist.size());                      // map rank to array giving number of objects per entity to be recvd
         cnt=0;
-        for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
+        for (MIT m=sendlist.begin(); m!=sendlist.end(); ++m)
         {
           // allocate send buffer for sizes per entitiy
-          size_t *buf = new size_t[is->grid.totalsize()];
-          send_sizes[cnt] = buf;
+          std::vector<size_t>& buf = send_sizes[cnt];
+          buf.resize(m->intersection->grid.totalsize());
 
           // loop over entities and ask for size
           int i=0; size_t n=0;
           typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
+          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubbegin()));
           typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubend()));
+          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubend()));
           for ( ; it!=tsubend; ++it)
           {
             buf[i] = data.size(*it);
@@ -765,45 +1182,36 @@ namespace Dune {
           send_size[cnt] = n;
 
           // hand over send request to torus class
-          MultiYGrid<dim,ctype>::torus().send(is->rank,buf,is->grid.totalsize()*sizeof(size_t));
+          MultiYGrid<dim,ctype>::torus().send(m->rank,bufferPointer(buf),m->intersection->grid.totalsize()*sizeof(size_t));
           cnt++;
         }
 
         // allocate recv buffers for sizes and store receive request
         cnt=0;
-        for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
+        for (MIT m=recvlist.begin(); m!=recvlist.end(); ++m)
         {
           // allocate recv buffer
-          size_t *buf = new size_t[is->grid.totalsize()];
-          recv_sizes[cnt] = buf;
+          std::vector<size_t>& buf = state.recv_sizes[cnt];
+          buf.resize(m->intersection->grid.totalsize());
 
           // hand over recv request to torus class
-          MultiYGrid<dim,ctype>::torus().recv(is->rank,buf,is->grid.totalsize()*sizeof(size_t));
+          MultiYGrid<dim,ctype>::torus().recv(m->rank,bufferPointer(buf),m->intersection->grid.totalsize()*sizeof(size_t));
           cnt++;
         }
 
         // exchange all size buffers now
         MultiYGrid<dim,ctype>::torus().exchange();
 
-        // release send size buffers
-        cnt=0;
-        for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
-        {
-          delete[] send_sizes[cnt];
-          send_sizes[cnt] = 0;
-          cnt++;
-        }
-
         // process receive size buffers
         cnt=0;
-        for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
+        for (MIT m=recvlist.begin(); m!=recvlist.end(); ++m)
         {
           // get recv buffer
-          size_t *buf = recv_sizes[cnt];
+          const std::vector<size_t>& buf = state.recv_sizes[cnt];
 
           // compute total size
           size_t n=0;
-          for (int i=0; i<is->grid.totalsize(); ++i)
+          for (int i=0; i<m->intersection->grid.totalsize(); ++i)
             n += buf[i];
 
           // ... and store it
@@ -814,108 +1222,104 @@ namespace Dune {
 
 
       // allocate & fill the send buffers & store send request
-      std::vector<DataType*> sends(sendlist->size(), static_cast<DataType*>(0)); // store pointers to send buffers
       cnt=0;
-      for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
+      for (MIT m=sendlist.begin(); m!=sendlist.end(); ++m)
       {
-        //      std::cout << "[" << this->comm().rank() << "] "
-        //                << " send " << " dest=" << is->rank
-        //                << " size=" << send_size[cnt]
-        //                << std::endl;
-
         // allocate send buffer
-        DataType *buf = new DataType[send_size[cnt]];
-
-        // remember send buffer
-        sends[cnt] = buf;
+        std::vector<DataType>& buf = state.sends[cnt];
+        buf.resize(send_size[cnt]);
 
         // make a message buffer
-        MessageBuffer<DataType> mb(buf);
+        MessageBuffer<DataType> mb(bufferPointer(buf));
 
         // fill send buffer; iterate over cells in intersection
         typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-        it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
+        it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubbegin()));
         typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-        tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubend()));
+        tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubend()));
         for ( ; it!=tsubend; ++it)
           data.gather(mb,*it);
 
         // hand over send request to torus class
-        MultiYGrid<dim,ctype>::torus().send(is->rank,buf,send_size[cnt]*sizeof(DataType));
+        MultiYGrid<dim,ctype>::torus().send(m->rank,bufferPointer(buf),send_size[cnt]*sizeof(DataType));
         cnt++;
       }
 
       // allocate recv buffers and store receive request
-      std::vector<DataType*> recvs(recvlist->size(),static_cast<DataType*>(0)); // store pointers to send buffers
       cnt=0;
-      for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
+      for (MIT m=recvlist.begin(); m!=recvlist.end(); ++m)
       {
-        //      std::cout << "[" << this->comm().rank() << "] "
-        //                << " recv " << "  src=" << is->rank
-        //                << " size=" << recv_size[cnt]
-        //                << std::endl;
-
         // allocate recv buffer
-        DataType *buf = new DataType[recv_size[cnt]];
-
-        // remember recv buffer
-        recvs[cnt] = buf;
+        std::vector<DataType>& buf = state.recvs[cnt];
+        buf.resize(recv_size[cnt]);
 
         // hand over recv request to torus class
-        MultiYGrid<dim,ctype>::torus().recv(is->rank,buf,recv_size[cnt]*sizeof(DataType));
+        MultiYGrid<dim,ctype>::torus().recv(m->rank,bufferPointer(buf),recv_size[cnt]*sizeof(DataType));
         cnt++;
       }
 
-      // exchange all buffers now
-      MultiYGrid<dim,ctype>::torus().exchange();
+      // post all messages now, they are completed in communicateCodimFinish
+      MultiYGrid<dim,ctype>::torus().exchange_start(state.exchange,handle.persistent());
+      state.active = true;
+    }
 
-      // release send buffers
-      cnt=0;
-      for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
-      {
-        delete[] sends[cnt];
-        sends[cnt] = 0;
-        cnt++;
-      }
+    /*! The new communication interface
 
-      // process receive buffers and delete them
-      cnt=0;
-      for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
-      {
-        // get recv buffer
-        DataType *buf = recvs[cnt];
+       finish the communication of objects for one codim
+     */
+    template<class Comm, int codim>
+    void communicateCodimFinish (Comm& handle) const
+    {
+      // data types
+      typedef typename Comm::DataType DataType;
+      typedef typename YaspCommunicationPlan<dim,ctype>::Message Message;
+      typedef typename std::vector<Message>::const_iterator MIT;
+
+      // nothing to do if this codim has not been started
+      typename Comm::CodimState& state = handle._state[codim];
+      if (!state.active) return;
+      state.active = false;
 
+      // wait for all messages of this codim
+      MultiYGrid<dim,ctype>::torus().exchange_finish(state.exchange);
+
+      // access to grid level and data
+      YGLI g = MultiYGrid<dim,ctype>::begin(state.plan->level());
+      typename Comm::DataHandle& data = *handle._data;
+
+      // process receive buffers
+      int cnt=0;
+      for (MIT m=state.plan->recvs().begin(); m!=state.plan->recvs().end(); ++m)
+      {
         // make a message buffer
-        MessageBuffer<DataType> mb(buf);
+        MessageBuffer<DataType> mb(bufferPointer(state.recvs[cnt]));
 
         // copy data from receive buffer; iterate over cells in intersection
         if (data.fixedsize(dim,codim))
         {
           typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
+          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubbegin()));
           size_t n=data.size(*it);
           typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubend()));
+          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubend()));
           for ( ; it!=tsubend; ++it)
             data.scatter(mb,*it,n);
         }
         else
         {
           int i=0;
-          size_t *sbuf = recv_sizes[cnt];
+          const std::vector<size_t>& sbuf = state.recv_sizes[cnt];
           typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
+          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubbegin()));
           typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubend()));
+          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,m->intersection->grid.tsubend()));
           for ( ; it!=tsubend; ++it)
             data.scatter(mb,*it,sbuf[i++]);
-          delete[] sbuf;
         }
-
-        // delete buffer
-        delete[] buf; // hier krachts !
         cnt++;
       }
+
+      // the buffers are kept for the next communication with this handle
     }
 
     // The new index sets from DDM 11.07.2005
@@ -940,6 +1344,12 @@ namespace Dune {
       return leafIndexSet_;
     }
 
+    //! the coordinates of the entities on the given level
+    const Coordinates& coordinates (int level) const
+    {
+      return levelCoordinates[level];
+    }
+
 #if HAVE_MPI
     /*! @brief return a collective communication object
      */
@@ -964,21 +1374,32 @@ namespace Dune {
     CollectiveCommunication<YaspGrid> ccobj;
 #endif
 
-    std::vector< shared_ptr< YaspIndexSet<const YaspGrid<dim>, false > > > indexsets;
-    YaspIndexSet<const YaspGrid<dim>, true> leafIndexSet_;
-    YaspGlobalIdSet<const YaspGrid<dim> > theglobalidset;
+    std::vector< shared_ptr< YaspIndexSet<const YaspGrid<dim,Coordinates>, false > > > indexsets;
+
+    // coordinates per level
+    std::vector<Coordinates> levelCoordinates;
+
+    // traversal order of the cells, see cellTraversalBlock()
+    FieldVector<int, dim> traversalBlock;
+    bool blockedTraversal;
+
+    // cached communication plans, see communicationPlan()
+    typedef std::map<int, shared_ptr<const YaspCommunicationPlan<dim,ctype> > > CommunicationPlanMap;
+    mutable CommunicationPlanMap commPlans;
+    YaspIndexSet<const YaspGrid<dim,Coordinates>, true> leafIndexSet_;
+    YaspGlobalIdSet<const YaspGrid<dim,Coordinates> > theglobalidset;
 
     // number of boundary segments of the level 0 grid
     int nBSegments;
 
     // Index classes need access to the real entity
-    friend class Dune::YaspIndexSet<const Dune::YaspGrid<dim>, true >;
-    friend class Dune::YaspIndexSet<const Dune::YaspGrid<dim>, false >;
-    friend class Dune::YaspGlobalIdSet<const Dune::YaspGrid<dim> >;
+    friend class Dune::YaspIndexSet<const Dune::YaspGrid<dim,Coordinates>, true >;
+    friend class Dune::YaspIndexSet<const Dune::YaspGrid<dim,Coordinates>, false >;
+    friend class Dune::YaspGlobalIdSet<const Dune::YaspGrid<dim,Coordinates> >;
 
-    friend class Dune::YaspIntersectionIterator<const Dune::YaspGrid<dim> >;
-    friend class Dune::YaspIntersection<const Dune::YaspGrid<dim> >;
-    friend class Dune::YaspEntity<0, dim, const Dune::YaspGrid<dim> >;
+    friend class Dune::YaspIntersectionIterator<const Dune::YaspGrid<dim,Coordinates> >;
+    friend class Dune::YaspIntersection<const Dune::YaspGrid<dim,Coordinates> >;
+    friend class Dune::YaspEntity<0, dim, const Dune::YaspGrid<dim,Coordinates> >;
 
     template <int codim_, class GridImp_>
     friend class Dune::YaspEntityPointer;
@@ -1019,10 +1440,32 @@ namespace Dune {
       mutable int j;
     };
 
+    // coordinate of the cell with the given consecutive index in a grid
+    static FieldVector<int, dim> decodeIndex (const YGrid<dim,ctype>& grid, int index)
+    {
+      FieldVector<int, dim> coord;
+      for (int i=0; i<dim; i++)
+      {
+        coord[i] = grid.origin(i) + index%grid.size(i);
+        index /= grid.size(i);
+      }
+      return coord;
+    }
+
+    //! pointer to the data of a message buffer, null for empty buffers
+    template<class T>
+    static T* bufferPointer (std::vector<T>& buf)
+    {
+      return buf.empty() ? 0 : &buf[0];
+    }
+
     void setsizes ()
     {
+      subIndexTables.resize(maxLevel()+1);
       for (YGLI g=MultiYGrid<dim,ctype>::begin(); g!=MultiYGrid<dim,ctype>::end(); ++g)
       {
+        makeSubIndexTable(g,subIndexTables[g.level()]);
+
         // codim 0 (elements)
         sizes[g.level()][0] = 1;
         for (int i=0; i<dim; ++i)
@@ -1063,6 +1506,124 @@ namespace Dune {
       }
     }
 
+    /** \brief Subentity indices of the cells of one level
+
+       The index of subentity i of codimension cc of the cell with global
+       coordinate c is offset[cc][i] + sum_k c[k]*stride[cc][i][k]. This
+       reproduces the lexicographic numbering of the index sets, i.e. the
+       vertices over the vertices of cell_overlap and the faces and edges
+       grouped into one lexicographic set per direction. The tables are
+       empty for cc=0 and for codimensions without subentity indices.
+     */
+    struct SubIndexTable
+    {
+      std::vector<int> offset[dim+1];
+      std::vector<FieldVector<int,dim> > stride[dim+1];
+    };
+
+    //! compute the subentity index table of level g
+    void makeSubIndexTable (const YGLI& g, SubIndexTable& t) const
+    {
+      FieldVector<int,dim> n, o;
+      for (int k=0; k<dim; k++)
+      {
+        n[k] = g.cell_overlap().size(k);
+        o[k] = g.cell_overlap().origin(k);
+      }
+
+      // codim dim (vertices), corner i is shifted by one in the directions of the bits of i
+      {
+        FieldVector<int,dim> stride;
+        int s=1;
+        for (int k=0; k<dim; k++)
+        {
+          stride[k] = s;
+          s *= n[k]+1;
+        }
+        t.offset[dim].resize(1<<dim);
+        t.stride[dim].assign(1<<dim,stride);
+        for (int i=0; i<(1<<dim); i++)
+        {
+          t.offset[dim][i] = 0;
+          for (int k=0; k<dim; k++)
+            t.offset[dim][i] += ((i&(1<<k)) ? 1-o[k] : -o[k])*stride[k];
+        }
+      }
+
+      // codim 1 (faces), faces 2*ivar and 2*ivar+1 vary in direction ivar
+      if (dim>1)
+      {
+        t.offset[1].resize(2*dim);
+        t.stride[1].resize(2*dim);
+        int base=0;
+        for (int ivar=0; ivar<dim; ivar++)
+        {
+          FieldVector<int,dim> stride;
+          int s=1;
+          for (int k=0; k<dim; k++)
+          {
+            stride[k] = s;
+            s *= (k==ivar) ? n[k]+1 : n[k];
+          }
+          for (int f=0; f<2; f++)
+          {
+            t.stride[1][2*ivar+f] = stride;
+            t.offset[1][2*ivar+f] = base + f*stride[ivar];
+            for (int k=0; k<dim; k++)
+              t.offset[1][2*ivar+f] -= o[k]*stride[k];
+          }
+          base += s;
+        }
+      }
+
+      // codim dim-1 (edges), the sets are ordered by decreasing fixed direction
+      if (dim>2)
+      {
+        // map from the reference element numbering to the order of the sets
+        static const int edge[ 12 ] = { 0, 1, 2, 3, 4, 5, 8, 9, 6, 7, 10, 11 };
+        const int m=1<<(dim-1);
+        t.offset[dim-1].resize(dim*m);
+        t.stride[dim-1].resize(dim*m);
+
+        Dune::array<int,dim> base;
+        int b=0;
+        for (int ifix=dim-1; ifix>=0; ifix--)
+        {
+          base[ifix] = b;
+          int s=n[ifix];
+          for (int l=0; l<dim; l++)
+            if (l!=ifix) s *= n[l]+1;
+          b += s;
+        }
+
+        for (int i=0; i<dim*m; i++)
+        {
+          const int j = (i<12) ? edge[i] : i;
+          const int ifix=(dim-1)-(j/m);
+
+          FieldVector<int,dim> stride;
+          int s=1;
+          for (int k=0; k<dim; k++)
+          {
+            stride[k] = s;
+            s *= (k!=ifix) ? n[k]+1 : n[k];
+          }
+
+          int offset=base[ifix];
+          int bit=1;
+          for (int k=0; k<dim; k++)
+          {
+            offset -= o[k]*stride[k];
+            if (k==ifix) continue;
+            if ((j%m)&bit) offset += stride[k];
+            bit *= 2;
+          }
+          t.stride[dim-1][i] = stride;
+          t.offset[dim-1][i] = offset;
+        }
+      }
+    }
+
     //! one past the end on this level
     template<int cd, PartitionIteratorType pitype>
     YaspLevelIterator<cd,pitype,GridImp> levelbegin (int level) const
@@ -1075,10 +1636,11 @@ namespace Dune {
         return levelend <cd, pitype> (level);
       if (cd==0)   // the elements
       {
+        const FieldVector<int, dim>* block = blockedTraversal ? &traversalBlock : 0;
         if (pitype<=InteriorBorder_Partition)
-          return YaspLevelIterator<cd,pitype,GridImp>(this,g,g.cell_interior().tsubbegin());
+          return YaspLevelIterator<cd,pitype,GridImp>(this,g,g.cell_interior().tsubbegin(),block);
         if (pitype<=All_Partition)
-          return YaspLevelIterator<cd,pitype,GridImp>(this,g,g.cell_overlap().tsubbegin());
+          return YaspLevelIterator<cd,pitype,GridImp>(this,g,g.cell_overlap().tsubbegin(),block);
       }
       if (cd==dim)   // the vertices
       {
@@ -1124,6 +1686,7 @@ namespace Dune {
     }
 
     int sizes[MAXL][dim+1]; // total number of entities per level and codim
+    std::vector<SubIndexTable> subIndexTables; // subentity index tables per level
     bool keep_ovlp;
     int adaptRefCount;
     bool adaptActive;
@@ -1143,8 +1706,8 @@ namespace Dune {
     /** \brief YaspGrid has only one geometry type for codim 0 entities
        \ingroup YaspGrid
      */
-    template<int dim>
-    struct hasSingleGeometryType< YaspGrid<dim> >
+    template<int dim, class Coordinates>
+    struct hasSingleGeometryType< YaspGrid<dim,Coordinates> >
     {
       static const bool v = true;
       static const unsigned int topologyId = GenericGeometry :: CubeTopology< dim > :: type :: id ;
@@ -1153,8 +1716,8 @@ namespace Dune {
     /** \brief YaspGrid is a Cartesian grid
         \ingroup YaspGrid
      */
-    template<int dim>
-    struct isCartesian< YaspGrid<dim> >
+    template<int dim, class Coordinates>
+    struct isCartesian< YaspGrid<dim,Coordinates> >
     {
       static const bool v = true;
     };
@@ -1162,8 +1725,8 @@ namespace Dune {
     /** \brief YaspGrid has codim=0 entities (elements)
        \ingroup YaspGrid
      */
-    template<int dim>
-    struct hasEntity< YaspGrid<dim>, 0 >
+    template<int dim, class Coordinates>
+    struct hasEntity< YaspGrid<dim,Coordinates>, 0 >
     {
       static const bool v = true;
     };
@@ -1171,20 +1734,20 @@ namespace Dune {
     /** \brief YaspGrid has codim=dim entities (vertices)
        \ingroup YaspGrid
      */
-    template<int dim>
-    struct hasEntity< YaspGrid<dim>, dim >
+    template<int dim, class Coordinates>
+    struct hasEntity< YaspGrid<dim,Coordinates>, dim >
     {
       static const bool v = true;
     };
 
-    template< int dim >
-    struct canCommunicate< YaspGrid< dim >, 0 >
+    template<int dim, class Coordinates>
+    struct canCommunicate< YaspGrid<dim,Coordinates>, 0 >
     {
       static const bool v = true;
     };
 
-    template< int dim >
-    struct canCommunicate< YaspGrid< dim >, dim >
+    template<int dim, class Coordinates>
+    struct canCommunicate< YaspGrid<dim,Coordinates>, dim >
     {
       static const bool v = true;
     };
@@ -1192,8 +1755,8 @@ namespace Dune {
     /** \brief YaspGrid is parallel
        \ingroup YaspGrid
      */
-    template<int dim>
-    struct isParallel< YaspGrid<dim> >
+    template<int dim, class Coordinates>
+    struct isParallel< YaspGrid<dim,Coordinates> >
     {
       static const bool v = true;
     };
@@ -1201,8 +1764,8 @@ namespace Dune {
     /** \brief YaspGrid is levelwise conforming
        \ingroup YaspGrid
      */
-    template<int dim>
-    struct isLevelwiseConforming< YaspGrid<dim> >
+    template<int dim, class Coordinates>
+    struct isLevelwiseConforming< YaspGrid<dim,Coordinates> >
     {
       static const bool v = true;
     };
@@ -1210,8 +1773,8 @@ namespace Dune {
     /** \brief YaspGrid is leafwise conforming
        \ingroup YaspGrid
      */
-    template<int dim>
-    struct isLeafwiseConforming< YaspGrid<dim> >
+    template<int dim, class Coordinates>
+    struct isLeafwiseConforming< YaspGrid<dim,Coordinates> >
     {
       static const bool v = true;
     };
@@ -0,0 +1,190 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRID_COORDINATES_HH
+#define DUNE_GRID_YASPGRID_COORDINATES_HH
+
+#include <vector>
+
+#include <dune/common/array.hh>
+#include <dune/common/fvector.hh>
+#include <dune/grid/common/exceptions.hh>
+
+/** \file
+ * \brief The coordinate policies of YaspGrid
+
+   A coordinate policy maps the integer coordinates of a YaspGrid entity on one
+   level to its position in world space. The index arithmetic of YaspGrid is the
+   same for all policies, only the geometries of the entities differ.
+
+   A policy provides the cell center and extension and the vertex position for a
+   SubYGrid::TransformingSubIterator, and the coordinates of the next finer level.
+ */
+
+namespace Dune {
+
+  /** \brief Coordinates of an equidistant YaspGrid
+
+     The positions are taken directly from the transforming iterator, which
+     computes them incrementally from the mesh size. This is the default
+     policy of YaspGrid.
+   */
+  template<class ct, int dim>
+  class EquidistantCoordinates
+  {
+  public:
+    //! the type of a coordinate
+    typedef ct ctype;
+    //! the type of a point in world space
+    typedef FieldVector<ct,dim> Vector;
+
+    //! make coordinates of the coarsest level, the mesh size is L[i]/s[i]
+    EquidistantCoordinates (const Vector& L, const Dune::array<int,dim>& s)
+    {}
+
+    //! the center of the cell the iterator points to
+    template<class TSI>
+    const Vector& center (const TSI& it) const
+    {
+      return it.position();
+    }
+
+    //! the extension of the cell the iterator points to
+    template<class TSI>
+    const Vector& extension (const TSI& it) const
+    {
+      return it.meshsize();
+    }
+
+    //! the position of the vertex the iterator points to
+    template<class TSI>
+    const Vector& vertex (const TSI& it) const
+    {
+      return it.position();
+    }
+
+    //! the coordinates of the next finer level
+    EquidistantCoordinates refine () const
+    {
+      return *this;
+    }
+  };
+
+  /** \brief Coordinates of a tensor-product YaspGrid
+
+     The vertex coordinates are given separately for each direction, e.g. to
+     grade the mesh towards a boundary layer. The arrays hold the global
+     coordinates of one level, i.e. their size grows with the number of cells
+     per direction and not with the number of entities. Refinement bisects
+     each interval.
+
+     Cells and vertices outside of the domain, which exist in the overlap of
+     periodic directions, are mapped to the periodic images of the coordinates.
+   */
+  template<class ct, int dim>
+  class TensorProductCoordinates
+  {
+  public:
+    //! the type of a coordinate
+    typedef ct ctype;
+    //! the type of a point in world space
+    typedef FieldVector<ct,dim> Vector;
+
+    //! make equidistant coordinates on [0,L[i]] with s[i] cells per direction
+    TensorProductCoordinates (const Vector& L, const Dune::array<int,dim>& s)
+    {
+      for (int i=0; i<dim; i++)
+      {
+        _c[i].resize(s[i]+1);
+        for (int k=0; k<=s[i]; k++)
+          _c[i][k] = (L[i]*k)/s[i];
+      }
+    }
+
+    /** \brief make coordinates from the vertex coordinates per direction
+
+       The coordinates of each direction have to be strictly increasing.
+     */
+    explicit TensorProductCoordinates (const Dune::array<std::vector<ct>,dim>& c)
+      : _c(c)
+    {
+      for (int i=0; i<dim; i++)
+      {
+        if (_c[i].size()<2)
+          DUNE_THROW(GridError, "TensorProductCoordinates: direction " << i << " needs at least two coordinates");
+        for (size_t k=1; k<_c[i].size(); k++)
+          if (!(_c[i][k-1]<_c[i][k]))
+            DUNE_THROW(GridError, "TensorProductCoordinates: coordinates of direction " << i << " are not increasing");
+      }
+    }
+
+    //! the center of the cell the iterator points to
+    template<class TSI>
+    Vector center (const TSI& it) const
+    {
+      Vector p;
+      for (int i=0; i<dim; i++)
+        p[i] = 0.5*(coordinate(i,it.coord(i))+coordinate(i,it.coord(i)+1));
+      return p;
+    }
+
+    //! the extension of the cell the iterator points to
+    template<class TSI>
+    Vector extension (const TSI& it) const
+    {
+      Vector h;
+      for (int i=0; i<dim; i++)
+        h[i] = coordinate(i,it.coord(i)+1)-coordinate(i,it.coord(i));
+      return h;
+    }
+
+    //! the position of the vertex the iterator points to
+    template<class TSI>
+    Vector vertex (const TSI& it) const
+    {
+      Vector p;
+      for (int i=0; i<dim; i++)
+        p[i] = coordinate(i,it.coord(i));
+      return p;
+    }
+
+    //! the coordinates of the next finer level
+    TensorProductCoordinates refine () const
+    {
+      Dune::array<std::vector<ct>,dim> c;
+      for (int i=0; i<dim; i++)
+      {
+        c[i].resize(2*_c[i].size()-1);
+        for (size_t k=0; k+1<_c[i].size(); k++)
+        {
+          c[i][2*k] = _c[i][k];
+          c[i][2*k+1] = 0.5*(_c[i][k]+_c[i][k+1]);
+        }
+        c[i].back() = _c[i].back();
+      }
+      return TensorProductCoordinates(c);
+    }
+
+    //! the coordinate of vertex k in direction i, k may lie in a periodic image of the domain
+    ct coordinate (int i, int k) const
+    {
+      const int n = _c[i].size()-1;
+      if (k>=0 && k<=n)
+        return _c[i][k];
+      // number of periods to shift
+      const int p = (k<0) ? -((n-1-k)/n) : k/n;
+      return _c[i][k-p*n] + p*(_c[i][n]-_c[i][0]);
+    }
+
+    //! the vertex coordinates of direction i
+    const std::vector<ct>& coordinates (int i) const
+    {
+      return _c[i];
+    }
+
+  private:
+    Dune::array<std::vector<ct>,dim> _c;
+  };
+
+}  // namespace Dune
+
+#endif // DUNE_GRID_YASPGRID_COORDINATES_HH
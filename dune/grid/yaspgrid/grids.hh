@@ -10,6 +10,8 @@
 #include <vector>
 #include <deque>
 #include <bitset>
+#include <map>
+#include <string>
 
 // C includes
 #if HAVE_MPI
@@ -657,9 +659,6 @@ namespace Dune {
       //! Make iterator pointing to first cell in subgrid.
       SubIterator (const SubYGrid<d,ct>& r) : YGrid<d,ct>::Iterator::Iterator (r)
       {
-        //! store some grid information
-        for (int i=0; i<d; ++i) _size[i] = r.size(i);
-
         // compute superincrements
         int inc = 1;
         for (int i=0; i<d; ++i)
@@ -677,9 +676,6 @@ namespace Dune {
       //! Make iterator pointing to given cell in subgrid.
       SubIterator (const SubYGrid<d,ct>& r, const iTupel& coord) : YGrid<d,ct>::Iterator::Iterator (r,coord)
       {
-        //! store some grid information
-        for (int i=0; i<d; ++i) _size[i] = r.size(i);
-
         // compute superincrements
         int inc = 1;
         for (int i=0; i<d; ++i)
@@ -703,9 +699,6 @@ namespace Dune {
       {
         YGrid<d,ct>::Iterator::reinit(r,coord);
 
-        //! store some grid information
-        for (int i=0; i<d; ++i) _size[i] = r.size(i);
-
         // compute superincrements
         int inc = 1;
         for (int i=0; i<d; ++i)
@@ -775,14 +768,14 @@ namespace Dune {
           else
           {
             this->_coord[i]=this->_origin[i];         // move back to origin in direction i
-            _superindex -= _size[i]*_superincrement[i];
+            _superindex -= (this->_end[i]-this->_origin[i]+1)*_superincrement[i];
           }
         }
         // if we wrapped around, back to to begin(), we must put the iterator to end()
         if (this->_coord == this->_origin)
         {
           for (int i=0; i<d; i++)
-            this->_superindex += (this->_size[i]-1)*this->_superincrement[i];
+            this->_superindex += (this->_end[i]-this->_origin[i])*this->_superincrement[i];
           this->_superindex += this->_superincrement[0];
         }
         return *this;
@@ -798,7 +791,6 @@ namespace Dune {
     protected:
       int _superindex;        //!< consecutive index in enclosing grid
       iTupel _superincrement; //!< moves consecutive index by one in this direction in supergrid
-      iTupel _size;           //!< size of subgrid
     };
 
     //! return subiterator to first element of index set
@@ -868,7 +860,7 @@ namespace Dune {
           else
           {
             this->_coord[i]=this->_origin[i];         // move back to origin in direction i
-            this->_superindex -= this->_size[i]*this->_superincrement[i];
+            this->_superindex -= (this->_end[i]-this->_origin[i]+1)*this->_superincrement[i];
             _position[i] = _begin[i];
           }
         }
@@ -876,7 +868,7 @@ namespace Dune {
         if (this->_coord == this->_origin)
         {
           for (int i=0; i<d; i++)
-            this->_superindex += (this->_size[i]-1)*this->_superincrement[i];
+            this->_superindex += (this->_end[i]-this->_origin[i])*this->_superincrement[i];
           this->_superindex += this->_superincrement[0];
         }
         return *this;
@@ -913,6 +905,40 @@ namespace Dune {
         _position[i] += dist*_h[i];
       }
 
+      /*! Increment iterator to next cell in a traversal by blocks. The subgrid is
+         divided into blocks of the given size starting at its origin, the blocks are
+         traversed in lexicographic order and the cells within each block as well.
+       */
+      TransformingSubIterator& blockincrement (const iTupel& block)
+      {
+        // next cell within the current block
+        for (int i=0; i<d; i++)
+        {
+          const int first = this->_origin[i] + ((this->_coord[i]-this->_origin[i])/block[i])*block[i];
+          if (this->_coord[i] < std::min(first+block[i]-1,this->_end[i]))
+          {
+            move(i,1);
+            return *this;
+          }
+          move(i,first-this->_coord[i]);  // back to first cell of the block in direction i
+        }
+        // first cell of the next block
+        for (int i=0; i<d; i++)
+        {
+          if (this->_coord[i]+block[i] <= this->_end[i])
+          {
+            move(i,block[i]);
+            return *this;
+          }
+          move(i,this->_origin[i]-this->_coord[i]);
+        }
+        // we wrapped around, back to begin(), we must put the iterator to end()
+        for (int i=0; i<d; i++)
+          this->_superindex += (this->_end[i]-this->_origin[i])*this->_superincrement[i];
+        this->_superindex += this->_superincrement[0];
+        return *this;
+      }
+
       //! Print contents of iterator
       void print (std::ostream& s) const
       {
@@ -985,6 +1011,48 @@ namespace Dune {
 
       optimize_dims(d-1,size,P,dims,trydims,opt);
     }
+
+    /** \brief split the cells of one direction into contiguous slabs
+
+       The default assigns the same number of cells to each slab, up to one.
+       @param i direction
+       @param size number of cells in direction i
+       @param parts number of slabs, i.e. number of processes in direction i
+       @param offsets returns the first cell of each slab and size, i.e. parts+1 entries
+     */
+    virtual void partition (int i, int size, int parts, std::vector<int>& offsets) const
+    {
+      int m = size/parts;
+      int r = size%parts;
+      offsets.resize(parts+1);
+      offsets[0] = 0;
+      for (int k=0; k<parts; k++)
+        offsets[k+1] = offsets[k] + ((k<parts-r) ? m : m+1);
+    }
+
+    //! return true if rankmap() needs the node of each process
+    virtual bool nodeaware () const
+    {
+      return false;
+    }
+
+    /** \brief assign the processes to the coordinates of the torus
+
+       The default is the lexicographic ordering, i.e. rank[k]=k.
+       @param dims the dimensions of the torus
+       @param node the node of each process, numbered consecutively from zero;
+              only set if nodeaware() returns true
+       @param rank returns the rank of the process at each torus coordinate in lexicographic ordering
+     */
+    virtual void rankmap (const iTupel& dims, const std::vector<int>& node, std::vector<int>& rank) const
+    {
+      int P = 1;
+      for (int i=0; i<d; i++) P *= dims[i];
+      rank.resize(P);
+      for (int k=0; k<P; k++)
+        rank[k] = k;
+    }
+
   private:
     void optimize_dims (int i, const iTupel& size, int P, iTupel& dims, iTupel& trydims, double &opt ) const
     {
@@ -1043,6 +1111,151 @@ namespace Dune {
     }
   };
 
+  /** \brief Yaspgrid load balance strategy for non-uniform cost and multi-core nodes
+
+     The cost of the cells may vary from slab to slab: for each direction a
+     weight per cell layer of the coarse grid can be given, the cost of a cell
+     is the product of the weights of its layers. The slabs of the partition are
+     chosen such that each process gets about the same total weight.
+
+     If node aware, the processes sharing a node are assigned to a compact block
+     of the torus, so most of their halo exchange stays within the node. This
+     requires the same number of processes on each node and a block shape dividing
+     the torus, otherwise the lexicographic ordering is kept.
+   */
+  template<int d>
+  class YLoadBalanceWeighted : public YLoadBalance<d>
+  {
+  public:
+    typedef FieldVector<int, d>  iTupel;
+
+    /** \brief make load balancer
+
+       @param weights cost of each cell layer of the coarse grid per direction,
+              an empty vector means uniform cost in this direction
+       @param nodeaware assign processes of the same node to a compact block
+     */
+    explicit YLoadBalanceWeighted (const Dune::array<std::vector<double>,d>& weights
+                                     = Dune::array<std::vector<double>,d>(),
+                                   bool nodeaware = true)
+      : _weights(weights), _nodeaware(nodeaware)
+    {}
+
+    virtual void partition (int i, int size, int parts, std::vector<int>& offsets) const
+    {
+      if (_weights[i].empty())
+      {
+        YLoadBalance<d>::partition(i,size,parts,offsets);
+        return;
+      }
+      if ((int)_weights[i].size()!=size)
+        DUNE_THROW(GridError, "YLoadBalanceWeighted: " << _weights[i].size()
+                                                      << " weights given for " << size << " cells in direction " << i);
+
+      // cut where the accumulated weight reaches the next multiple of the average
+      double total = 0.0;
+      for (int k=0; k<size; k++) total += _weights[i][k];
+      offsets.resize(parts+1);
+      offsets[0] = 0;
+      double sum = 0.0;
+      int cell = 0;
+      for (int j=1; j<parts; j++)
+      {
+        const double target = (total*j)/parts;
+        while (cell<size && sum+0.5*_weights[i][cell]<target)
+          sum += _weights[i][cell++];
+        // each slab keeps at least one cell
+        const int c = std::min(std::max(cell,offsets[j-1]+1),size-(parts-j));
+        for (; cell<c; cell++) sum += _weights[i][cell];
+        for (; cell>c; cell--) sum -= _weights[i][cell-1];
+        offsets[j] = cell;
+      }
+      offsets[parts] = size;
+    }
+
+    virtual bool nodeaware () const
+    {
+      return _nodeaware;
+    }
+
+    virtual void rankmap (const iTupel& dims, const std::vector<int>& node, std::vector<int>& rank) const
+    {
+      YLoadBalance<d>::rankmap(dims,node,rank);
+      if (!_nodeaware || node.empty()) return;
+
+      // processes per node, the same for all nodes
+      const int P = node.size();
+      const int nodes = *std::max_element(node.begin(),node.end())+1;
+      if (P%nodes!=0) return;
+      const int c = P/nodes;
+      std::vector<int> count(nodes,0);
+      for (int r=0; r<P; r++) count[node[r]]++;
+      for (int n=0; n<nodes; n++)
+        if (count[n]!=c) return;
+
+      // shape of the block of one node with minimal surface
+      iTupel block, tryblock;
+      double opt = 1E100;
+      optimize_block(d-1,dims,c,block,tryblock,opt);
+      if (opt>=1E100) return;
+
+      // ranks of each node in ascending order
+      std::vector<std::vector<int> > ranks(nodes);
+      for (int r=0; r<P; r++) ranks[node[r]].push_back(r);
+
+      // blocks in lexicographic order are assigned to the nodes,
+      // the coordinates within a block lexicographically to its ranks
+      iTupel nblocks;
+      for (int i=0; i<d; i++) nblocks[i] = dims[i]/block[i];
+      for (int k=0; k<P; k++)
+      {
+        int rest = k;
+        int b = 0, l = 0, binc = 1, linc = 1;
+        for (int i=0; i<d; i++)
+        {
+          const int x = rest%dims[i];
+          rest /= dims[i];
+          b += (x/block[i])*binc;
+          l += (x%block[i])*linc;
+          binc *= nblocks[i];
+          linc *= block[i];
+        }
+        rank[k] = ranks[b][l];
+      }
+    }
+
+  private:
+    // find block with c processes dividing the torus and minimal surface
+    void optimize_block (int i, const iTupel& dims, int c, iTupel& block, iTupel& tryblock, double& opt) const
+    {
+      if (i>0)
+      {
+        for (int k=1; k<=c; k++)
+          if (c%k==0 && dims[i]%k==0)
+          {
+            tryblock[i] = k;
+            optimize_block(i-1,dims,c/k,block,tryblock,opt);
+          }
+      }
+      else
+      {
+        if (dims[0]%c!=0) return;
+        tryblock[0] = c;
+        double surface = 0.0;
+        for (int k=0; k<d; k++)
+          surface += 1.0/tryblock[k];
+        if (surface<opt)
+        {
+          opt = surface;
+          block = tryblock;
+        }
+      }
+    }
+
+    Dune::array<std::vector<double>,d> _weights;
+    bool _nodeaware;
+  };
+
   /*! Torus provides all the functionality to handle a toroidal communication structure:
 
      - Map a set of processes (given by an MPI communicator) to a torus of dimension d. The "optimal"
@@ -1104,22 +1317,7 @@ namespace Dune {
 #endif
       _tag = tag;
 
-      // determine dimensions
-      lb->loadbalance(size, _procs, _dims);
-      // if (_rank==0) std::cout << "Torus<" << d
-      //                         << ">: mapping " << _procs << " processes onto "
-      //                         << _dims << " torus." << std::endl;
-
-      // compute increments for lexicographic ordering
-      int inc = 1;
-      for (int i=0; i<d; i++)
-      {
-        _increment[i] = inc;
-        inc *= _dims[i];
-      }
-
-      // make full schedule
-      proclists();
+      setup(size,lb);
     }
 
     //! make partitioner from communicator and coarse mesh size
@@ -1139,21 +1337,9 @@ namespace Dune {
 #endif
       _tag = tag;
 
-      // determine dimensions
       iTupel sizeITupel;
       std::copy(size.begin(), size.end(), sizeITupel.begin());
-      lb->loadbalance(sizeITupel, _procs, _dims);
-
-      // compute increments for lexicographic ordering
-      int inc = 1;
-      for (int i=0; i<d; i++)
-      {
-        _increment[i] = inc;
-        inc *= _dims[i];
-      }
-
-      // make full schedule
-      proclists();
+      setup(sizeITupel,lb);
     }
 
 
@@ -1209,26 +1395,26 @@ namespace Dune {
       return true;
     }
 
-    //! map rank to coordinate in torus using lexicographic ordering
+    //! map rank to coordinate in torus, see YLoadBalance::rankmap()
     iTupel rank_to_coord (int rank) const
     {
       iTupel coord;
-      rank = rank%_procs;
+      int index = _index_of_rank[rank%_procs];
       for (int i=d-1; i>=0; i--)
       {
-        coord[i] = rank/_increment[i];
-        rank = rank%_increment[i];
+        coord[i] = index/_increment[i];
+        index = index%_increment[i];
       }
       return coord;
     }
 
-    //! map coordinate in torus to rank using lexicographic ordering
+    //! map coordinate in torus to rank, see YLoadBalance::rankmap()
     int coord_to_rank (iTupel coord) const
     {
       for (int i=0; i<d; i++) coord[i] = coord[i]%_dims[i];
-      int rank = 0;
-      for (int i=0; i<d; i++) rank += coord[i]*_increment[i];
-      return rank;
+      int index = 0;
+      for (int i=0; i<d; i++) index += coord[i]*_increment[i];
+      return _rank_of_index[index];
     }
 
     //! return rank of process where its coordinate in direction dir has offset cnt (handles periodic case)
@@ -1309,24 +1495,18 @@ namespace Dune {
       // make a tensor product partition
       for (int i=0; i<d; i++)
       {
-        // determine
-        int m = size_in[i]/_dims[i];
-        int r = size_in[i]%_dims[i];
+        // slabs of the load balancer if made for this size, equal slabs otherwise
+        std::vector<int> offsets;
+        if (size_in[i]==_size[i])
+          offsets = _offsets[i];
+        else
+          YLoadBalance<d>().partition(i,size_in[i],_dims[i],offsets);
 
         sz *= size_in[i];
 
-        if (coord[i]<_dims[i]-r)
-        {
-          origin_out[i] = origin_in[i] + coord[i]*m;
-          size_out[i] = m;
-          maxsize *= m;
-        }
-        else
-        {
-          origin_out[i] = origin_in[i] + (_dims[i]-r)*m + (coord[i]-(_dims[i]-r))*(m+1);
-          size_out[i] = m+1;
-          maxsize *= m+1;
-        }
+        origin_out[i] = origin_in[i] + offsets[coord[i]];
+        size_out[i] = offsets[coord[i]+1] - offsets[coord[i]];
+        maxsize *= size_out[i];
       }
       return maxsize/(sz/_procs);
     }
@@ -1447,9 +1627,104 @@ namespace Dune {
         _localrecvrequests.push_back(task);
     }
 
+    /*! \brief handle of an exchange started with exchange_start()
+
+       The handle takes over all requests stored with send() and recv() before the
+       exchange was started. The buffers of these requests must remain valid until
+       exchange_finish() has been called for the handle.
+
+       If the exchange was started as persistent, the handle keeps the MPI requests
+       after the exchange has finished. A later persistent exchange with the same
+       partners, buffers and sizes restarts them instead of posting new requests.
+     */
+    class ExchangeHandle {
+      friend class Torus<d>;
+
+      // the handle may own MPI requests
+      ExchangeHandle (const ExchangeHandle&);
+      ExchangeHandle& operator= (const ExchangeHandle&);
+
+    public:
+      //! make a handle without requests
+      ExchangeHandle ()
+        : _active(false), _persistent(false)
+      {}
+
+      //! free persistent requests
+      ~ExchangeHandle ()
+      {
+        release();
+      }
+
+      //! return true if messages of this exchange may still be in transit
+      bool pending () const
+      {
+        return _active;
+      }
+
+    private:
+      // return true if two request lists describe the same messages
+      static bool same (const std::vector<CommTask>& a, const std::vector<CommTask>& b)
+      {
+        if (a.size()!=b.size()) return false;
+        for (unsigned int i=0; i<a.size(); i++)
+          if (a[i].rank!=b[i].rank || a[i].buffer!=b[i].buffer || a[i].size!=b[i].size)
+            return false;
+        return true;
+      }
+
+      // free persistent requests and forget all requests
+      void release ()
+      {
+#if HAVE_MPI
+        if (_persistent)
+        {
+          int finalized;
+          MPI_Finalized(&finalized);
+          if (!finalized)
+          {
+            for (unsigned int i=0; i<_sendrequests.size(); i++)
+              MPI_Request_free(&(_sendrequests[i].request));
+            for (unsigned int i=0; i<_recvrequests.size(); i++)
+              MPI_Request_free(&(_recvrequests[i].request));
+          }
+        }
+#endif
+        _sendrequests.clear();
+        _recvrequests.clear();
+        _persistent = false;
+      }
+
+      std::vector<CommTask> _sendrequests;
+      std::vector<CommTask> _recvrequests;
+      bool _active;     // messages are in transit
+      bool _persistent; // requests are persistent and kept after the exchange
+    };
+
     //! exchange messages stored in request buffers; clear request buffers afterwards
     void exchange () const
     {
+      ExchangeHandle handle;
+      exchange_start(handle);
+      exchange_finish(handle);
+    }
+
+    /*! \brief start the exchange of the messages stored in the request buffers
+
+       Local requests are handled immediately by memcpy, requests to foreign processes
+       are posted as nonblocking sends and receives and handed over to the given
+       handle. The request buffers of the torus are cleared, i.e. new send() and
+       recv() requests can be stored while the exchange is in progress.
+
+       If persistent is true, persistent MPI requests are used and kept in the handle,
+       see ExchangeHandle.
+     */
+    void exchange_start (ExchangeHandle& handle, bool persistent = false) const
+    {
+      // a handle can only be used for one exchange at a time
+      if (handle._active)
+        exchange_finish(handle);
+
       // handle local requests first
       if (_localsendrequests.size()!=_localrecvrequests.size())
       {
@@ -1468,72 +1743,113 @@ namespace Dune {
       _localsendrequests.clear();
       _localrecvrequests.clear();
 
-#if HAVE_MPI
-      // handle foreign requests
-      int sends=0;
-      int recvs=0;
+      // can the persistent requests of the last exchange be restarted?
+      bool reuse = persistent && handle._persistent
+                   && ExchangeHandle::same(handle._sendrequests,_sendrequests)
+                   && ExchangeHandle::same(handle._recvrequests,_recvrequests);
 
+      // otherwise the handle takes over the foreign requests
+      if (!reuse)
+      {
+        handle.release();
+        handle._sendrequests.swap(_sendrequests);
+        handle._recvrequests.swap(_recvrequests);
+        handle._persistent = persistent;
+      }
+      _sendrequests.clear();
+      _recvrequests.clear();
+      handle._active = true;
+
+#if HAVE_MPI
       // issue sends to foreign processes
-      for (unsigned int i=0; i<_sendrequests.size(); i++)
-        if (_sendrequests[i].rank!=rank())
+      for (unsigned int i=0; i<handle._sendrequests.size(); i++)
+      {
+        CommTask& task = handle._sendrequests[i];
+        if (!persistent)
+          MPI_Isend(task.buffer, task.size, MPI_BYTE, task.rank, _tag, _comm, &(task.request));
+        else
         {
-          //          std::cout << "[" << rank() << "]" << " send " << _sendrequests[i].size << " bytes "
-          //                    << "to " << _sendrequests[i].rank << " p=" << _sendrequests[i].buffer << std::endl;
-          MPI_Isend(_sendrequests[i].buffer, _sendrequests[i].size, MPI_BYTE,
-                    _sendrequests[i].rank, _tag, _comm, &(_sendrequests[i].request));
-          _sendrequests[i].flag = false;
-          sends++;
+          if (!reuse)
+            MPI_Send_init(task.buffer, task.size, MPI_BYTE, task.rank, _tag, _comm, &(task.request));
+          MPI_Start(&(task.request));
         }
+        task.flag = false;
+      }
 
       // issue receives from foreign processes
-      for (unsigned int i=0; i<_recvrequests.size(); i++)
-        if (_recvrequests[i].rank!=rank())
+      for (unsigned int i=0; i<handle._recvrequests.size(); i++)
+      {
+        CommTask& task = handle._recvrequests[i];
+        if (!persistent)
+          MPI_Irecv(task.buffer, task.size, MPI_BYTE, task.rank, _tag, _comm, &(task.request));
+        else
         {
-          //          std::cout << "[" << rank() << "]"  << " recv " << _recvrequests[i].size << " bytes "
-          //                    << "fm " << _recvrequests[i].rank << " p=" << _recvrequests[i].buffer << std::endl;
-          MPI_Irecv(_recvrequests[i].buffer, _recvrequests[i].size, MPI_BYTE,
-                    _recvrequests[i].rank, _tag, _comm, &(_recvrequests[i].request));
-          _recvrequests[i].flag = false;
-          recvs++;
+          if (!reuse)
+            MPI_Recv_init(task.buffer, task.size, MPI_BYTE, task.rank, _tag, _comm, &(task.request));
+          MPI_Start(&(task.request));
         }
-
-      // poll sends
-      while (sends>0)
-      {
-        for (unsigned int i=0; i<_sendrequests.size(); i++)
-          if (!_sendrequests[i].flag)
-          {
-            MPI_Status status;
-            MPI_Test( &(_sendrequests[i].request), &(_sendrequests[i].flag), &status);
-            if (_sendrequests[i].flag)
-            {
-              sends--;
-              //                  std::cout << "[" << rank() << "]"  << " send to " << _sendrequests[i].rank << " OK" << std::endl;
-            }
-          }
+        task.flag = false;
       }
+#endif
+    }
 
-      // poll receives
-      while (recvs>0)
-      {
-        for (unsigned int i=0; i<_recvrequests.size(); i++)
-          if (!_recvrequests[i].flag)
-          {
-            MPI_Status status;
-            MPI_Test( &(_recvrequests[i].request), &(_recvrequests[i].flag), &status);
-            if (_recvrequests[i].flag)
-            {
-              recvs--;
-              //                  std::cout << "[" << rank() << "]"  << " recv fm " << _recvrequests[i].rank << " OK" << std::endl;
-            }
+    /*! \brief check whether an exchange started with exchange_start() has completed
 
-          }
-      }
+       This method does not block, it only drives the progress of the pending messages.
+       If true is returned, all receive buffers have been filled and exchange_finish()
+       will return immediately.
+     */
+    bool exchange_test (ExchangeHandle& handle) const
+    {
+      bool ready = true;
+#if HAVE_MPI
+      if (!handle._active) return ready;
+      for (unsigned int i=0; i<handle._sendrequests.size(); i++)
+        if (!handle._sendrequests[i].flag)
+        {
+          MPI_Status status;
+          MPI_Test( &(handle._sendrequests[i].request), &(handle._sendrequests[i].flag), &status);
+          ready = ready && handle._sendrequests[i].flag;
+        }
+      for (unsigned int i=0; i<handle._recvrequests.size(); i++)
+        if (!handle._recvrequests[i].flag)
+        {
+          MPI_Status status;
+          MPI_Test( &(handle._recvrequests[i].request), &(handle._recvrequests[i].flag), &status);
+          ready = ready && handle._recvrequests[i].flag;
+        }
+#endif
+      return ready;
+    }
 
-      // clear request buffers
-      _sendrequests.clear();
-      _recvrequests.clear();
+    //! wait until all messages of an exchange started with exchange_start() have been delivered
+    void exchange_finish (ExchangeHandle& handle) const
+    {
+      if (!handle._active) return;
+#if HAVE_MPI
+      for (unsigned int i=0; i<handle._sendrequests.size(); i++)
+        if (!handle._sendrequests[i].flag)
+        {
+          MPI_Status status;
+          MPI_Wait( &(handle._sendrequests[i].request), &status);
+          handle._sendrequests[i].flag = true;
+        }
+      for (unsigned int i=0; i<handle._recvrequests.size(); i++)
+        if (!handle._recvrequests[i].flag)
+        {
+          MPI_Status status;
+          MPI_Wait( &(handle._recvrequests[i].request), &status);
+          handle._recvrequests[i].flag = true;
+        }
 #endif
+      handle._active = false;
+
+      // clear request buffers, persistent requests are kept for the next exchange
+      if (!handle._persistent)
+      {
+        handle._sendrequests.clear();
+        handle._recvrequests.clear();
+      }
     }
 
     //! global max
@@ -1570,6 +1886,74 @@ namespace Dune {
 
   private:
 
+    // determine torus dimensions, partition and rank mapping from the load balancer
+    void setup (const iTupel& size, const YLoadBalance<d>* lb)
+    {
+      // determine dimensions
+      lb->loadbalance(size, _procs, _dims);
+      // if (_rank==0) std::cout << "Torus<" << d
+      //                         << ">: mapping " << _procs << " processes onto "
+      //                         << _dims << " torus." << std::endl;
+
+      // compute increments for lexicographic ordering
+      int inc = 1;
+      for (int i=0; i<d; i++)
+      {
+        _increment[i] = inc;
+        inc *= _dims[i];
+      }
+
+      // slabs per direction
+      _size = size;
+      for (int i=0; i<d; i++)
+      {
+        lb->partition(i,size[i],_dims[i],_offsets[i]);
+        if ((int)_offsets[i].size()!=_dims[i]+1 || _offsets[i][0]!=0 || _offsets[i][_dims[i]]!=size[i])
+          DUNE_THROW(GridError, "Torus: invalid partition of direction " << i);
+      }
+
+      // assign processes to torus coordinates
+      std::vector<int> node;
+      if (lb->nodeaware())
+        nodes(node);
+      lb->rankmap(_dims,node,_rank_of_index);
+      _index_of_rank.assign(_procs,-1);
+      if ((int)_rank_of_index.size()==_procs)
+        for (int k=0; k<_procs; k++)
+          if (_rank_of_index[k]>=0 && _rank_of_index[k]<_procs)
+            _index_of_rank[_rank_of_index[k]] = k;
+      for (int r=0; r<_procs; r++)
+        if (_index_of_rank[r]<0)
+          DUNE_THROW(GridError, "Torus: rank map is not a permutation");
+
+      // make full schedule
+      proclists();
+    }
+
+    // number the nodes by their processor names in order of their lowest rank
+    void nodes (std::vector<int>& node) const
+    {
+      node.assign(_procs,0);
+#if HAVE_MPI
+      char name[MPI_MAX_PROCESSOR_NAME];
+      memset(name,0,MPI_MAX_PROCESSOR_NAME);
+      int len;
+      MPI_Get_processor_name(name,&len);
+      std::vector<char> names(_procs*MPI_MAX_PROCESSOR_NAME);
+      MPI_Allgather(name,MPI_MAX_PROCESSOR_NAME,MPI_CHAR,&names[0],MPI_MAX_PROCESSOR_NAME,MPI_CHAR,_comm);
+      std::map<std::string,int> numbers;
+      for (int r=0; r<_procs; r++)
+      {
+        names[(r+1)*MPI_MAX_PROCESSOR_NAME-1] = 0;
+        std::string n(&names[r*MPI_MAX_PROCESSOR_NAME]);
+        std::map<std::string,int>::iterator it = numbers.find(n);
+        if (it==numbers.end())
+          it = numbers.insert(std::make_pair(n,int(numbers.size()))).first;
+        node[r] = it->second;
+      }
+#endif
+    }
+
     void proclists ()
     {
       // compile the full neighbor list
@@ -1629,6 +2013,10 @@ namespace Dune {
     int _procs;
     iTupel _dims;
     iTupel _increment;
+    iTupel _size;                          // coarse grid size the partition was made for
+    Dune::array<std::vector<int>,d> _offsets; // first cell of each slab per direction
+    std::vector<int> _rank_of_index;       // rank of each torus coordinate in lexicographic ordering
+    std::vector<int> _index_of_rank;       // inverse of _rank_of_index
     int _tag;
     std::deque<CommPartner> _sendlist;
     std::deque<CommPartner> _recvlist;
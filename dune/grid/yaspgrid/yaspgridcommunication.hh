@@ -0,0 +1,200 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDCOMMUNICATION_HH
+#define DUNE_GRID_YASPGRIDCOMMUNICATION_HH
+
+/** \file
+ * \brief The YaspCommunicationPlan and YaspCommunication classes
+
+   YaspCommunicationPlan describes the messages exchanged by one communication,
+   YaspCommunication is the handle of a split-phase communication on
+   a YaspGrid, see YaspGrid::communicateBegin().
+ */
+
+namespace Dune {
+
+  /** \brief Precomputed layout of the messages of a communication on a YaspGrid
+
+     A plan is determined by codimension, interface, direction and level. It lists
+     the messages to be sent to and received from the neighboring processes together
+     with the indices of the entities in the order in which their data is packed.
+     YaspGrid computes each plan once and keeps it until the grid is refined or
+     coarsened, see YaspGrid::communicationPlan().
+   */
+  template<int dim, class ctype>
+  class YaspCommunicationPlan
+  {
+  public:
+    typedef typename MultiYGrid<dim,ctype>::Intersection IS;
+
+    //! a message to or from one neighboring process
+    struct Message
+    {
+      const IS* intersection;   //!< the entities as a subgrid of the local grid
+      int rank;                 //!< rank of the neighboring process
+      std::vector<int> indices; //!< level index of each entity in the order of the message
+    };
+
+    //! make plan from the lists of intersections to send and to receive
+    YaspCommunicationPlan (int level, const std::deque<IS>& sendlist, const std::deque<IS>& recvlist)
+      : _level(level)
+    {
+      makeMessages(sendlist,_sends);
+      makeMessages(recvlist,_recvs);
+    }
+
+    //! the grid level
+    int level () const
+    {
+      return _level;
+    }
+
+    //! the messages to be sent
+    const std::vector<Message>& sends () const
+    {
+      return _sends;
+    }
+
+    //! the messages to be received
+    const std::vector<Message>& recvs () const
+    {
+      return _recvs;
+    }
+
+  private:
+    static void makeMessages (const std::deque<IS>& list, std::vector<Message>& messages)
+    {
+      messages.resize(list.size());
+      int cnt=0;
+      for (typename std::deque<IS>::const_iterator is=list.begin(); is!=list.end(); ++is)
+      {
+        Message& m = messages[cnt++];
+        m.intersection = &(*is);
+        m.rank = is->rank;
+        m.indices.reserve(is->grid.totalsize());
+
+        // the index of an entity is its consecutive index in the local grid enclosing the intersection
+        typename SubYGrid<dim,ctype>::SubIterator end = is->grid.subend();
+        for (typename SubYGrid<dim,ctype>::SubIterator it = is->grid.subbegin(); it!=end; ++it)
+          m.indices.push_back(it.superindex());
+      }
+    }
+
+    int _level;
+    std::vector<Message> _sends;
+    std::vector<Message> _recvs;
+  };
+
+  /** \brief Handle of a split-phase communication on a YaspGrid
+
+     The communication is started with YaspGrid::communicateBegin(), which gathers
+     the data to be sent from the data handle and posts all messages. It is completed
+     with finish(), which waits for the messages and scatters the received data
+     into the data handle. In between, the process may do any work that does not
+     depend on the data of the receiving entities, e.g. assemble the interior
+     elements.
+
+     The data handle must remain valid until the communication has finished.
+     Several communications may be in progress at the same time, but all processes
+     must start them in the same order. A communication which is still pending
+     is finished in the destructor. The grid must not be refined or coarsened
+     while a communication is pending.
+
+     A handle can be reused for repeated communications. It keeps its message buffers
+     between communications, so exchanging the same interface again does not allocate.
+     If constructed as persistent, it additionally keeps persistent MPI requests
+     (MPI_Send_init/MPI_Recv_init) which are restarted as long as the message sizes
+     do not change.
+
+     \tparam GridImp The YaspGrid class
+     \tparam DataHandleImp The implementation of the data handle, i.e. a class
+             derived from CommDataHandleIF
+   */
+  template<class GridImp, class DataHandleImp>
+  class YaspCommunication
+  {
+    enum { dim=GridImp::dimension };
+    typedef typename GridImp::ctype ctype;
+
+    // the handle owns the message buffers used by pending requests
+    YaspCommunication (const YaspCommunication&);
+    YaspCommunication& operator= (const YaspCommunication&);
+
+    template<int, class> friend class YaspGrid;
+
+  public:
+    //! type of the data handle interface
+    typedef CommDataHandleIF<DataHandleImp,typename DataHandleImp::DataType> DataHandle;
+    //! type of the communicated data
+    typedef typename DataHandle::DataType DataType;
+
+    //! make a handle not associated with any communication
+    explicit YaspCommunication (bool persistent = false)
+      : _yg(0), _data(0), _persistent(persistent)
+    {}
+
+    //! finish a pending communication
+    ~YaspCommunication ()
+    {
+      finish();
+    }
+
+    //! return true if the communication has been started but not finished
+    bool pending () const
+    {
+      return _yg != 0;
+    }
+
+    /** \brief return true if all messages have arrived, i.e. finish() will not block
+
+       This method does not block, it may be called repeatedly to drive the progress
+       of the messages.
+     */
+    bool ready () const
+    {
+      if (!pending()) return true;
+      bool r = true;
+      for (int codim=0; codim<=dim; codim++)
+        if (_state[codim].active)
+          r = _yg->torus().exchange_test(_state[codim].exchange) && r;
+      return r;
+    }
+
+    //! wait for all messages and scatter the received data into the data handle
+    void finish ()
+    {
+      if (!pending()) return;
+      _yg->communicateFinish(*this);
+    }
+
+    //! return true if persistent MPI requests are used
+    bool persistent () const
+    {
+      return _persistent;
+    }
+
+  private:
+    // the state of the communication for one codimension
+    struct CodimState
+    {
+      CodimState ()
+        : active(false)
+      {}
+
+      bool active;                                // communication for this codim is in progress
+      shared_ptr<const YaspCommunicationPlan<dim,ctype> > plan; // the messages
+      std::vector<std::vector<DataType> > sends;  // send buffers per intersection
+      std::vector<std::vector<DataType> > recvs;  // recv buffers per intersection
+      std::vector<std::vector<size_t> > recv_sizes; // number of objects per entity (variable size only)
+      mutable typename Torus<dim>::ExchangeHandle exchange; // the messages in transit
+    };
+
+    const GridImp* _yg;        // the grid, null if no communication is pending
+    DataHandle* _data;         // the data handle
+    CodimState _state[dim+1];  // state per codimension
+    bool _persistent;          // use persistent MPI requests
+  };
+
+}   // namespace Dune
+
+#endif   // DUNE_GRID_YASPGRIDCOMMUNICATION_HH
@@ -162,7 +162,7 @@ namespace Dune {
      *  to generate the entity again and uses as less memory as possible
      */
     EntitySeed seed () const {
-      return EntitySeed(YaspEntitySeed<0,GridImp>(_g.level(), _it.coord()));
+      return EntitySeed(YaspEntitySeed<0,GridImp>(_g.level(), _it.superindex()));
     }
 
     //! return partition type attribute
@@ -178,7 +178,8 @@ namespace Dune {
     //! geometry of this entity
     Geometry geometry () const {
       // the element geometry
-      GeometryImpl _geometry(_it.position(),_it.meshsize());
+      const typename GridImp::CoordinatesType& coordinates = _yg->coordinates(_g.level());
+      GeometryImpl _geometry(coordinates.center(_it),coordinates.extension(_it));
       return Geometry( _geometry );
     }
 
@@ -534,98 +535,16 @@ namespace Dune {
       if (cc==0)
         return compressedIndex();
 
-      // get cell position relative to origin of local cell grid
-      iTupel coord;
-      for (int k=0; k<dim; ++k)
-        coord[k] = _it.coord(k)-_g.cell_overlap().origin(k);
-
-      if (cc==dim) // vertices
-      {
-        // transform cell coordinate to corner coordinate
-        for (int k=0; k<dim; k++)
-          if (i&(1<<k)) (coord[k])++;
-
-        // do lexicographic numbering
-        int index = coord[dim-1];
-        for (int k=dim-2; k>=0; --k)
-          index = (index*(_g.cell_overlap().size(k)+1))+coord[k];
-        return index;
-      }
-
-      if (cc==1) // faces, i.e. for dim=2 codim=1 is treated as a face
-      {
-        // Idea: direction ivar varies, all others are fixed, i.e. 2 possibilities per direction
-
-        // ivar is the direction that varies
-        int ivar=i/2;
-
-        // compute position from cell position
-        if (i%2) coord[ivar] += 1;
-
-        // do lexicographic numbering
-        int index = coord[dim-1];
-        for (int k=dim-2; k>=0; --k)
-          if (k==ivar)
-            index = (index*(_g.cell_overlap().size(k)+1))+coord[k]; // one more
-          else
-            index = (index*(_g.cell_overlap().size(k)))+coord[k];
-
-        // add size of all subsets for smaller directions
-        for (int j=0; j<ivar; j++)
-        {
-          int n=_g.cell_overlap().size(j)+1;
-          for (int l=0; l<dim; l++)
-            if (l!=j) n *= _g.cell_overlap().size(l);
-          index += n;
-        }
-
-        return index;
-      }
+      // offset and strides of the subentity are precomputed per level
+      const typename GridImp::SubIndexTable& t = _yg->subIndexTables[_g.level()];
+      if (cc>dim || t.offset[cc].empty())
+        DUNE_THROW(GridError, "codim " << cc << " (dim=" << dim << ") not (yet) implemented");
 
-      // map to old numbering
-      static unsigned int edge[ 12 ] = { 0, 1, 2, 3, 4, 5, 8, 9, 6, 7, 10, 11 };
-      i = edge[i];
-
-      if (cc==dim-1) // edges, exist only for dim>2
-      {
-        // Idea: direction i is fixed, all others are vary, i.e. 2^(dim-1) possibilities per direction
-
-        // number of entities per direction
-        int m=1<<(dim-1);
-
-        // ifix is the direction that is fixed
-        int ifix=(dim-1)-(i/m);
-
-        // compute position from cell position
-        int bit=1;
-        for (int k=0; k<dim; k++)
-        {
-          if (k==ifix) continue;
-          if ((i%m)&bit) coord[k] += 1;
-          bit *= 2;
-        }
-
-        // do lexicographic numbering
-        int index = coord[dim-1];
-        for (int k=dim-2; k>=0; --k)
-          if (k!=ifix)
-            index = (index*(_g.cell_overlap().size(k)+1))+coord[k]; // one more
-          else
-            index = (index*(_g.cell_overlap().size(k)))+coord[k];
-
-        // add size of all subsets for smaller directions
-        for (int j=dim-1; j>ifix; j--)
-        {
-          int n=_g.cell_overlap().size(j);
-          for (int l=0; l<dim; l++)
-            if (l!=j) n *= _g.cell_overlap().size(l)+1;
-          index += n;
-        }
-
-        return index;
-      }
-
-      DUNE_THROW(GridError, "codim " << cc << " (dim=" << dim << ") not (yet) implemented");
+      const FieldVector<int,dim>& stride = t.stride[cc][i];
+      int index = t.offset[cc][i];
+      for (int k=0; k<dim; ++k)
+        index += _it.coord(k)*stride[k];
+      return index;
     }
 
     //! subentity compressed index
@@ -788,12 +707,12 @@ namespace Dune {
      *  to generate the entity again and uses as little memory as possible
      */
     EntitySeed seed () const {
-      return EntitySeed(YaspEntitySeed<dim,GridImp>(_g.level(), _it.coord()));
+      return EntitySeed(YaspEntitySeed<dim,GridImp>(_g.level(), _it.superindex()));
     }
 
     //! geometry of this entity
     Geometry geometry () const {
-      GeometryImpl _geometry(_it.position());
+      GeometryImpl _geometry(_yg->coordinates(_g.level()).vertex(_it));
       return Geometry( _geometry );
     }
 
@@ -111,6 +111,11 @@ namespace Dune {
       return _g;
     }
 
+    const GridImp * yaspgrid () const
+    {
+      return GridImp::getRealImplementation(_entity).yaspgrid();
+    }
+
   protected:
     YGLI _g;             // access to grid level
     TSI _it;             // position in the grid level
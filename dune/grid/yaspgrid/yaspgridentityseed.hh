@@ -10,33 +10,33 @@
 namespace Dune {
 
   /** \brief Describes the minimal information necessary to create a fully functional YaspEntity
+
+     The seed consists of the level and the index of the entity in the index set of
+     its level, the coordinates are decoded when the entity pointer is made.
    */
   template<int codim, class GridImp>
   class YaspEntitySeed
   {
-    //! know your own dimension
-    enum { dim=GridImp::dimension };
-
   public:
     //! codimension of entity pointer
     enum { codimension = codim };
 
     //! constructor
-    YaspEntitySeed (int level, FieldVector<int, dim> coord)
-      : _l(level), _c(coord)
+    YaspEntitySeed (int level, int index)
+      : _l(level), _i(index)
     {}
 
     //! copy constructor
     YaspEntitySeed (const YaspEntitySeed& rhs)
-      : _l(rhs._l), _c(rhs._c)
+      : _l(rhs._l), _i(rhs._i)
     {}
 
     int level () const { return _l; }
-    const FieldVector<int, dim> & coord() const { return _c; }
+    int index () const { return _i; }
 
   protected:
     int _l;                  // grid level
-    FieldVector<int, dim> _c; // coord in the global grid
+    int _i;                  // consecutive index in the local grid of the level
   };
 
 }  // namespace Dune
@@ -44,7 +44,6 @@ namespace Dune {
 
       // cleanup old stuff
       _outside.transformingsubiterator().move(_dir,1-2*_face);   // move home
-      _pos_world[_dir] = _inside.transformingsubiterator().position(_dir);
 
       // update face info
       _dir = _count / 2;
@@ -52,9 +51,6 @@ namespace Dune {
 
       // move transforming iterator
       _outside.transformingsubiterator().move(_dir,-1+2*_face);
-
-      // make up faces
-      _pos_world[_dir] += (-0.5+_face)*_inside.transformingsubiterator().meshsize(_dir);
     }
 
     /*! return true if neighbor ist outside the domain. Still the neighbor might
@@ -76,6 +72,28 @@ namespace Dune {
               _inside.transformingsubiterator().coord(_count/2) + 2*(_count%2) - 1 <= _inside.gridlevel().cell_overlap().max(_count/2));
     }
 
+    //! return true if the intersection lies on a periodic boundary, i.e. the neighbor is a periodic image
+    bool periodic () const
+    {
+      return boundary() && _inside.gridlevel().mg()->periodic(_count/2);
+    }
+
+    //! index of the inside element in the index set of its level
+    int insideIndex () const
+    {
+      return _inside.transformingsubiterator().superindex();
+    }
+
+    /*! index of the neighbor in the index set of the level of the inside element,
+       computed from the index of the inside element without moving to the neighbor;
+       returns -1 if the neighbor does not exist in this process (see neighbor())
+     */
+    int outsideIndex () const
+    {
+      if (!neighbor()) return -1;
+      return _inside.transformingsubiterator().superneighbor(_count/2,2*(_count%2)-1);
+    }
+
     //! Yasp is always conform
     bool conforming () const
     {
@@ -219,8 +237,12 @@ namespace Dune {
     Geometry geometry () const
     {
       update();
-      GeometryImpl
-      _is_global(_pos_world,_inside.transformingsubiterator().meshsize(),_dir);
+      // make up face from the cell geometry
+      const typename GridImp::CoordinatesType& coordinates = _inside.yaspgrid()->coordinates(_inside.level());
+      const FieldVector<ctype, dimworld>& h = coordinates.extension(_inside.transformingsubiterator());
+      FieldVector<ctype, dimworld> p = coordinates.center(_inside.transformingsubiterator());
+      p[_dir] += (-0.5+_face)*h[_dir];
+      GeometryImpl _is_global(p,h,_dir);
       return Geometry( _is_global );
     }
 
@@ -253,8 +275,7 @@ namespace Dune {
       // initialize to first neighbor
       _count(0),
       _dir(0),
-      _face(0),
-      _pos_world(myself.transformingsubiterator().position())
+      _face(0)
     {
       if (toend)
       {
@@ -266,9 +287,6 @@ namespace Dune {
 
       // move transforming iterator
       _outside.transformingsubiterator().move(_dir,-1);
-
-      // make up faces
-      _pos_world[0] -= 0.5*_inside.transformingsubiterator().meshsize(0);
     }
 
     //! copy constructor
@@ -277,8 +295,7 @@ namespace Dune {
       _outside(it._outside),
       _count(it._count),
       _dir(it._dir),
-      _face(it._face),
-      _pos_world(it._pos_world)
+      _face(it._face)
     {}
 
     //! copy operator
@@ -289,7 +306,6 @@ namespace Dune {
       _count = it._count;
       _dir = it._dir;
       _face = it._face;
-      _pos_world = it._pos_world;
     }
 
   private:
@@ -300,8 +316,6 @@ namespace Dune {
     uint8_t _count;                                //!< valid neighbor count in 0 .. 2*dim-1
     mutable uint8_t _dir;                          //!< count/2
     mutable uint8_t _face;                         //!< count%2
-    /* current position */
-    mutable FieldVector<ctype, dimworld> _pos_world;       //!< center of face in world coordinates
 
     /* static data */
     struct faceInfo
@@ -28,17 +28,35 @@ namespace Dune {
 
     //! constructor
     YaspLevelIterator (const GridImp * yg, const YGLI & g, const TSI & it) :
-      YaspEntityPointer<codim,GridImp>(yg,g,it) {}
+      YaspEntityPointer<codim,GridImp>(yg,g,it), _block(0) {}
+
+    //! constructor for a traversal by blocks of the given size, lexicographic if block is null
+    YaspLevelIterator (const GridImp * yg, const YGLI & g, const TSI & it, const FieldVector<int, dim>* block) :
+      YaspEntityPointer<codim,GridImp>(yg,g,it), _block(block) {}
 
     //! copy constructor
     YaspLevelIterator (const YaspLevelIterator& i) :
-      YaspEntityPointer<codim,GridImp>(i) {}
+      YaspEntityPointer<codim,GridImp>(i), _block(i._block) {}
+
+    //! assignment
+    YaspLevelIterator& operator= (const YaspLevelIterator& i)
+    {
+      YaspEntityPointer<codim,GridImp>::operator=(i);
+      _block = i._block;
+      return *this;
+    }
 
     //! increment
     void increment()
     {
-      ++(this->_it);
+      if (_block)
+        this->_it.blockincrement(*_block);
+      else
+        ++(this->_it);
     }
+
+  private:
+    const FieldVector<int, dim>* _block; // block size of the traversal, null for lexicographic order
   };
 
 }
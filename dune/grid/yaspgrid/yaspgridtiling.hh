@@ -0,0 +1,77 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDTILING_HH
+#define DUNE_GRID_YASPGRIDTILING_HH
+
+/** \file
+ * \brief The YaspTile class
+
+   A YaspTile is a contiguous part of the interior cells of one level of a YaspGrid,
+   see YaspGrid::tiles().
+ */
+
+namespace Dune {
+
+  /** \brief A contiguous block of interior cells of a YaspGrid level
+
+     The tiles of a level are disjoint and cover all interior cells. Each tile
+     is a box of cells which spans the full interior extent in the fast directions,
+     so its cells are traversed in the lexicographic order of the index set and
+     the data of a tile is a contiguous range of a vector ordered by the index set
+     (up to the gaps of the overlap cells).
+
+     The tiles may be iterated concurrently, e.g. by the threads of a thread pool,
+     as long as the grid is not modified.
+   */
+  template<class GridImp>
+  class YaspTile
+  {
+    enum { dim=GridImp::dimension };
+    typedef typename GridImp::ctype ctype;
+
+  public:
+    typedef typename MultiYGrid<dim,ctype>::YGridLevelIterator YGLI;
+    //! the iterator over the cells of a tile
+    typedef typename GridImp::template Codim<0>::template Partition<Interior_Partition>::LevelIterator Iterator;
+
+    //! default number of cells of a tile, meant to keep the data of a tile in the L2 cache
+    enum { defaultSize = 2048 };
+
+    //! make tile of the cells of a subgrid of the given level
+    YaspTile (const GridImp* yg, const YGLI& g, const SubYGrid<dim,ctype>& grid)
+      : _yg(yg), _g(g), _grid(grid)
+    {}
+
+    //! iterator to the first cell of the tile
+    Iterator begin () const
+    {
+      return YaspLevelIterator<0,Interior_Partition,GridImp>(_yg,_g,_grid.tsubbegin());
+    }
+
+    //! iterator past the last cell of the tile
+    Iterator end () const
+    {
+      return YaspLevelIterator<0,Interior_Partition,GridImp>(_yg,_g,_grid.tsubend());
+    }
+
+    //! number of cells in the tile
+    int size () const
+    {
+      return _grid.totalsize();
+    }
+
+    //! the cells of the tile as a subgrid of the local cells of the level
+    const SubYGrid<dim,ctype>& grid () const
+    {
+      return _grid;
+    }
+
+  private:
+    const GridImp* _yg;
+    YGLI _g;
+    SubYGrid<dim,ctype> _grid;
+  };
+
+}   // namespace Dune
+
+#endif   // DUNE_GRID_YASPGRIDTILING_HH